@@ -0,0 +1,100 @@
+#ifndef AI_LOD
+#define AI_LOD
+
+#include <raylib.h>
+#include <raymath.h>
+
+#include "components.hpp"
+
+const int AI_LOD_BUCKETS(4);  // Reduced-rate mobs steer once every N ticks
+const float AI_LOD_FULL_RATE_DISTANCE(400.0f);
+const int AI_LOD_MAX_STALE_TICKS(AI_LOD_BUCKETS * 2);  // Force an update after this
+const int AI_LOD_TICK_BUDGET(200);  // Reduced-rate steering updates per tick
+
+struct AILodComponent {
+  Vector2 extrapolatedVelocity = {0.0f, 0.0f};  // Displacement per second
+  int bucket = 0;
+  int ticksSinceUpdate = AI_LOD_MAX_STALE_TICKS;  // New mobs steer right away
+};
+
+// Decides which mobs run their full steering on a given tick.
+// Mobs that are on screen and near the player always steer. The rest are
+// spread over round-robin buckets, only one bucket steers per tick, and in
+// between the mobs keep moving with their last steering velocity.
+struct AILodScheduler {
+  int currentBucket = 0;
+  int nextBucket = 0;
+  int budgetLeft = AI_LOD_TICK_BUDGET;
+
+  // Cost accounting, in steering updates. Reduced-rate updates are charged
+  // to the mob's own bucket, forced ones included, and a bucket's counts
+  // cover the ticks since its last turn began.
+  int fullRateUpdates = 0;
+  int bucketUpdates[AI_LOD_BUCKETS] = {};
+  int bucketDeferred[AI_LOD_BUCKETS] = {};  // Skipped because of the budget
+
+  Vector2 focus;
+  Rectangle view;
+
+  void assign(AILodComponent& lod) {
+    lod.bucket = nextBucket;
+    nextBucket = (nextBucket + 1) % AI_LOD_BUCKETS;
+  }
+
+  void beginTick(const Vector2 _focus, const Rectangle _view) {
+    focus = _focus;
+    view = _view;
+    currentBucket = (currentBucket + 1) % AI_LOD_BUCKETS;
+    budgetLeft = AI_LOD_TICK_BUDGET;
+    fullRateUpdates = 0;
+    bucketUpdates[currentBucket] = 0;
+    bucketDeferred[currentBucket] = 0;
+  }
+
+  bool isFullRate(const Vector2 position) const {
+    return CheckCollisionPointRec(position, view) &&
+           Vector2DistanceSqr(position, focus) <=
+             AI_LOD_FULL_RATE_DISTANCE * AI_LOD_FULL_RATE_DISTANCE;
+  }
+
+  bool shouldUpdate(AILodComponent& lod, const Vector2 position) {
+    if (isFullRate(position)) {
+      fullRateUpdates++;
+      return true;
+    }
+
+    bool isDue = lod.bucket == currentBucket ||
+                 lod.ticksSinceUpdate >= AI_LOD_MAX_STALE_TICKS;
+    if (!isDue) return false;
+
+    if (budgetLeft <= 0) {
+      bucketDeferred[lod.bucket]++;
+      return false;
+    }
+    budgetLeft--;
+    bucketUpdates[lod.bucket]++;
+    return true;
+  }
+};
+
+// Run a steering function at the rate chosen by the scheduler, and
+// extrapolate the character's position on the ticks in between
+template <typename SteerFunction>
+static void steerWithLod(
+  AILodScheduler& scheduler, AILodComponent& lod, CharacterComponent& c,
+  const float timestep, SteerFunction steer
+) {
+  if (scheduler.shouldUpdate(lod, c.position)) {
+    Vector2 previousPosition = c.position;
+    steer(c);
+    lod.extrapolatedVelocity =
+      Vector2Scale(Vector2Subtract(c.position, previousPosition), 1 / timestep);
+    lod.ticksSinceUpdate = 0;
+  } else {
+    c.position =
+      Vector2Add(c.position, Vector2Scale(lod.extrapolatedVelocity, timestep));
+    lod.ticksSinceUpdate++;
+  }
+}
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef ALLOC_TRACK
+#define ALLOC_TRACK
+
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// What a frame's heap allocations are charged to
+enum AllocationSubsystem {
+  ALLOC_OTHER,
+  ALLOC_SIMULATION,
+  ALLOC_ROLLBACK,
+  ALLOC_SPAWNING,
+  ALLOC_EVENTS,
+  ALLOC_UI,
+  ALLOC_RENDERING,
+  ALLOC_SUBSYSTEM_COUNT
+};
+
+const char* ALLOC_SUBSYSTEM_NAMES[ALLOC_SUBSYSTEM_COUNT] = {
+  "other", "simulation", "rollback", "spawning", "events", "ui", "rendering"};
+
+struct AllocationCounts {
+  size_t allocations = 0;
+  size_t bytes = 0;
+};
+
+// Heap allocations made by the game thread, per subsystem and per frame.
+// Other threads (raylib's audio mixer) get their own copy and are not shown.
+struct AllocationTracker {
+  AllocationCounts frame[ALLOC_SUBSYSTEM_COUNT];
+  AllocationCounts lastFrame[ALLOC_SUBSYSTEM_COUNT];
+  AllocationSubsystem current = ALLOC_OTHER;
+  bool forbidden = false;  // Set while a zero-allocation tick runs
+  size_t forbiddenAllocations = 0;  // Over the whole run
+
+  void record(const size_t size) {
+    frame[current].allocations++;
+    frame[current].bytes += size;
+    if (forbidden) {
+      forbiddenAllocations++;
+      assert(!"Heap allocation during a zero-allocation tick");
+    }
+  }
+
+  void endFrame() {
+    for (int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+      lastFrame[i] = frame[i];
+      frame[i] = {};
+    }
+  }
+
+  AllocationCounts lastFrameTotal() const {
+    AllocationCounts total;
+    for (int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+      total.allocations += lastFrame[i].allocations;
+      total.bytes += lastFrame[i].bytes;
+    }
+    return total;
+  }
+};
+
+thread_local AllocationTracker allocationTracker;
+
+// Charges the allocations made while in scope to a subsystem
+struct AllocationScope {
+  AllocationSubsystem previous;
+
+  AllocationScope(const AllocationSubsystem subsystem)
+      : previous(allocationTracker.current) {
+    allocationTracker.current = subsystem;
+  }
+
+  ~AllocationScope() { allocationTracker.current = previous; }
+};
+
+// Makes any allocation while in scope an error, when forbid is true
+struct NoAllocationScope {
+  bool previous;
+
+  NoAllocationScope(const bool forbid) : previous(allocationTracker.forbidden) {
+    allocationTracker.forbidden = forbid;
+  }
+
+  ~NoAllocationScope() { allocationTracker.forbidden = previous; }
+};
+
+// Replacements for the global allocation functions, so that allocations made
+// inside entt, the standard library and raylib's C++ side are counted too.
+// This header must be included by a single translation unit.
+static void* trackedAllocate(const size_t size) {
+  allocationTracker.record(size);
+  return malloc(size ? size : 1);
+}
+
+static void* trackedAllocateAligned(const size_t size, const size_t alignment) {
+  allocationTracker.record(size);
+#ifdef _WIN32
+  return _aligned_malloc(size ? size : 1, alignment);
+#else
+  // posix_memalign refuses alignments below a pointer's, which std::pmr
+  // passes for small types
+  size_t pointerAlignment =
+    alignment < sizeof(void*) ? sizeof(void*) : alignment;
+  void* p = nullptr;
+  if (posix_memalign(&p, pointerAlignment, size ? size : 1) != 0) {
+    return nullptr;
+  }
+  return p;
+#endif
+}
+
+static void trackedFreeAligned(void* p) {
+#ifdef _WIN32
+  _aligned_free(p);
+#else
+  free(p);
+#endif
+}
+
+void* operator new(const size_t size) {
+  if (void* p = trackedAllocate(size)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](const size_t size) {
+  if (void* p = trackedAllocate(size)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new(const size_t size, const std::nothrow_t&) noexcept {
+  return trackedAllocate(size);
+}
+
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept {
+  return trackedAllocate(size);
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment) {
+  if (void* p = trackedAllocateAligned(size, size_t(alignment))) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment) {
+  if (void* p = trackedAllocateAligned(size, size_t(alignment))) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t) noexcept {
+  trackedFreeAligned(p);
+}
+void operator delete[](void* p, std::align_val_t) noexcept {
+  trackedFreeAligned(p);
+}
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+  trackedFreeAligned(p);
+}
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+  trackedFreeAligned(p);
+}
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef ARENA
+#define ARENA
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+const size_t FRAME_ARENA_SIZE(1024 * 1024);
+
+// Linear allocator for scratch data that only lives for one tick.
+// Allocating bumps an offset, freeing does nothing and reset() drops
+// everything at once. Requests that do not fit go to the heap and are
+// released on reset, so running out of space is slow but never fatal.
+struct FrameArena {
+  unsigned char* memory = nullptr;
+  size_t capacity = 0;
+  size_t offset = 0;
+  bool ownsMemory = false;
+  uint32_t generation = 0;  // Bumped by every reset()
+
+  std::vector<void*> overflow;  // Heap blocks used once the arena was full
+
+  // Usage reporting, in bytes
+  size_t lastTickBytes = 0;  // Used during the previous tick
+  size_t highWaterMark = 0;  // Most ever used during a single tick
+  size_t overflowBytes = 0;  // Heap bytes used during the current tick
+
+  FrameArena() {}
+
+  FrameArena(const size_t _capacity) {
+    memory = static_cast<unsigned char*>(::operator new(_capacity));
+    capacity = _capacity;
+    ownsMemory = true;
+  }
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  FrameArena(FrameArena&& other) { *this = std::move(other); }
+
+  FrameArena& operator=(FrameArena&& other) {
+    std::swap(memory, other.memory);
+    std::swap(capacity, other.capacity);
+    std::swap(offset, other.offset);
+    std::swap(ownsMemory, other.ownsMemory);
+    std::swap(generation, other.generation);
+    overflow.swap(other.overflow);
+    std::swap(lastTickBytes, other.lastTickBytes);
+    std::swap(highWaterMark, other.highWaterMark);
+    std::swap(overflowBytes, other.overflowBytes);
+    return *this;
+  }
+
+  ~FrameArena() {
+    releaseOverflow();
+    if (ownsMemory) ::operator delete(memory);
+  }
+
+  void* allocate(const size_t size, const size_t alignment) {
+    uintptr_t base = reinterpret_cast<uintptr_t>(memory);
+    uintptr_t aligned = (base + offset + alignment - 1) & ~(alignment - 1);
+    size_t newOffset = aligned - base + size;
+    if (memory && newOffset <= capacity) {
+      offset = newOffset;
+      return reinterpret_cast<void*>(aligned);
+    }
+
+    void* block = ::operator new(size);
+    overflow.push_back(block);
+    overflowBytes += size;
+    return block;
+  }
+
+  // Hand part of this arena to a worker thread so it can allocate without
+  // contending with the others. The block counts towards this arena's
+  // usage and the sub-arena is only valid until reset(). Unused while the
+  // simulation is single threaded.
+  FrameArena carve(const size_t size) {
+    FrameArena sub;
+    sub.memory = static_cast<unsigned char*>(
+      allocate(size, alignof(std::max_align_t))
+    );
+    sub.capacity = size;
+    return sub;
+  }
+
+  size_t used() const { return offset + overflowBytes; }
+
+  // Start a new tick
+  void reset() {
+    lastTickBytes = used();
+    if (lastTickBytes > highWaterMark) highWaterMark = lastTickBytes;
+    releaseOverflow();
+    offset = 0;
+    generation++;
+  }
+
+  void releaseOverflow() {
+    for (size_t i = 0; i < overflow.size(); i++) {
+      ::operator delete(overflow[i]);
+    }
+    overflow.clear();
+    overflowBytes = 0;
+  }
+};
+
+// Standard allocator that takes its memory from a FrameArena
+template <typename T>
+struct ArenaAllocator {
+  using value_type = T;
+
+  FrameArena* arena;
+
+  ArenaAllocator(FrameArena* _arena) : arena(_arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+  T* allocate(const size_t n) {
+    return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t) {}
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const {
+    return arena == other.arena;
+  }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const {
+    return arena != other.arena;
+  }
+};
+
+// Vector for one tick's worth of data, must not outlive the arena's reset()
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Empty an arena vector and give it a new buffer of capacity elements from
+// its arena. clear() would keep a buffer a reset() already handed back.
+template <typename T>
+static void renewArenaVector(ArenaVector<T>& vector, const size_t capacity) {
+  ArenaVector<T>(vector.get_allocator()).swap(vector);
+  vector.reserve(capacity);
+}
+
+#endif
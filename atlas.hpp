@@ -0,0 +1,163 @@
+#ifndef ATLAS
+#define ATLAS
+
+#include <raylib.h>
+
+#include <cstring>
+#include <iostream>
+
+#define STB_RECT_PACK_IMPLEMENTATION
+#define STBRP_STATIC  // raylib links its own copy for font atlases
+// The static copy has helpers the packing calls here never reach
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#include "external/stb_rect_pack.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+const int ATLAS_PADDING(2);  // Transparent pixels around every region
+const int ATLAS_MAX_SIZE(4096);
+const int ATLAS_WHITE_SIZE(4);  // Solid block raylib draws shapes from
+const int ATLAS_CIRCLE_SIZE(32);  // White disc bullets are drawn from
+
+enum AtlasSprite {
+  SPRITE_PLAYER,
+  SPRITE_PLAYER_ATTACKING,
+  SPRITE_MELEE,
+  SPRITE_RANGED,
+  SPRITE_BULLET,
+  SPRITE_CURSOR,
+  SPRITE_WHITE,  // Generated, not loaded
+  SPRITE_CIRCLE,  // Generated, not loaded
+  SPRITE_COUNT
+};
+
+struct AtlasSource {
+  const char* name;
+  const char* path;
+  Rectangle used;  // Part of the image that is drawn, empty to trim to alpha
+};
+
+// The used regions are the source rectangles the draw code had before the
+// atlas. The cursor keeps its full image so its tip stays at the mouse.
+const AtlasSource ATLAS_SOURCES[SPRITE_COUNT] = {
+  {"player", "./assets/knight.png", {0, 0, 200, 106}},
+  {"playerAttacking", "./assets/knightAttack.png", {0, 0, 200, 106}},
+  {"melee", "./assets/enemyMelee.png", {56, 120, 430, 280}},
+  {"ranged", "./assets/enemyRanged.png", {108, 128, 280, 267}},
+  {"bullet", "./assets/Bullet.png", {}},
+  {"cursor", "./assets/cursorSword.png", {0, 0, 100, 100}},
+  {"white", nullptr, {0, 0, ATLAS_WHITE_SIZE, ATLAS_WHITE_SIZE}},
+  {"circle", nullptr, {0, 0, ATLAS_CIRCLE_SIZE, ATLAS_CIRCLE_SIZE}},
+};
+
+// Images for the sprites with no file, at the size of their used region
+static Image generateAtlasImage(const int sprite, const Rectangle used) {
+  Image image = GenImageColor(int(used.width), int(used.height), BLANK);
+  if (sprite == SPRITE_CIRCLE) {
+    int radius = int(used.width) / 2;
+    ImageDrawCircle(&image, radius, radius, radius - 1, WHITE);
+  } else {
+    ImageClearBackground(&image, WHITE);
+  }
+  return image;
+}
+
+// Every game sprite packed into one texture at startup, so the world draws
+// without a single texture change. Regions are looked up by AtlasSprite, or
+// by name for code that only has a string.
+struct TextureAtlas {
+  Texture2D texture = {};
+  Rectangle regions[SPRITE_COUNT] = {};
+
+  bool build() {
+    Image images[SPRITE_COUNT];
+    stbrp_rect rects[SPRITE_COUNT];
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+      const AtlasSource& source = ATLAS_SOURCES[i];
+      if (source.path) {
+        images[i] = LoadImage(source.path);
+      } else {
+        images[i] = generateAtlasImage(i, source.used);
+      }
+      Rectangle used = source.used;
+      if (used.width <= 0.0f || used.height <= 0.0f) {
+        used = GetImageAlphaBorder(images[i], 0.0f);
+      }
+      ImageCrop(&images[i], used);
+
+      rects[i].id = i;
+      rects[i].w = images[i].width + ATLAS_PADDING * 2;
+      rects[i].h = images[i].height + ATLAS_PADDING * 2;
+    }
+
+    // Smallest power of two square everything fits in
+    int size = 256;
+    while (!pack(rects, size)) {
+      size *= 2;
+      if (size > ATLAS_MAX_SIZE) {
+        std::cout << "Sprites do not fit in a " << ATLAS_MAX_SIZE << " atlas"
+                  << std::endl;
+        for (int i = 0; i < SPRITE_COUNT; i++) UnloadImage(images[i]);
+        return false;
+      }
+    }
+
+    Image atlas = GenImageColor(size, size, BLANK);
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+      Rectangle region = {
+        float(rects[i].x + ATLAS_PADDING), float(rects[i].y + ATLAS_PADDING),
+        float(images[i].width), float(images[i].height)};
+      ImageDraw(
+        &atlas, images[i],
+        {0, 0, float(images[i].width), float(images[i].height)}, region,
+        WHITE
+      );
+      regions[i] = region;
+      UnloadImage(images[i]);
+    }
+    texture = LoadTextureFromImage(atlas);
+    UnloadImage(atlas);
+
+    // Shapes sample the middle of the white block, clear of filtered edges
+    Rectangle white = regions[SPRITE_WHITE];
+    SetShapesTexture(
+      texture, {white.x + 1, white.y + 1, white.width - 2, white.height - 2}
+    );
+    return true;
+  }
+
+  // Hands shapes back to the default font's white glyph, as InitWindow does
+  void unload() {
+    Rectangle rec = GetFontDefault().recs[95];
+    SetShapesTexture(
+      GetFontDefault().texture,
+      {rec.x + 1, rec.y + 1, rec.width - 2, rec.height - 2}
+    );
+    UnloadTexture(texture);
+  }
+
+  const Rectangle& region(const AtlasSprite sprite) const {
+    return regions[sprite];
+  }
+
+  // Region of the sprite with the given name, an empty rectangle if unknown
+  Rectangle region(const char* name) const {
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+      if (strcmp(ATLAS_SOURCES[i].name, name) == 0) return regions[i];
+    }
+    return {};
+  }
+
+  static bool pack(stbrp_rect* rects, const int size) {
+    stbrp_node nodes[ATLAS_MAX_SIZE];
+    stbrp_context context;
+    stbrp_init_target(&context, size, size, nodes, size);
+    return stbrp_pack_rects(&context, rects, SPRITE_COUNT) == 1;
+  }
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef BULLET_BENCH
+#define BULLET_BENCH
+
+#include <raylib.h>
+#include <rlgl.h>
+
+#include "spritebatch.hpp"
+
+const int BULLET_BENCH_COUNT(10000);
+const float BULLET_BENCH_RADIUS(5.0f);  // Same as a ranged enemy's bullet
+const int BULLET_BENCH_FAN_VERTICES(4 * 36 / 2);  // DrawCircleV, 36 segments
+
+// CPU time to build and submit one frame of bullets, for each way of
+// drawing them
+struct BulletBenchResult {
+  int bullets;
+  size_t fanVertices;
+  size_t quadVertices;
+  double fanMs;  // DrawCircleV, as bullets were drawn before the batch quads
+  double quadMs;  // One atlas quad per bullet through the sprite batch
+};
+
+static Vector2 bulletBenchPosition(const int i, const int width, const int height) {
+  return {float((i * 7919) % width), float((i * 104729) % height)};
+}
+
+// Must run between BeginDrawing and EndDrawing, before the frame is cleared,
+// so the bullets drawn here never show
+static BulletBenchResult benchmarkBulletRendering(
+  SpriteBatch& batch, const int width, const int height
+) {
+  BulletBenchResult result;
+  result.bullets = BULLET_BENCH_COUNT;
+  result.fanVertices = size_t(BULLET_BENCH_COUNT) * BULLET_BENCH_FAN_VERTICES;
+  result.quadVertices = size_t(BULLET_BENCH_COUNT) * 4;
+
+  rlDrawRenderBatchActive();
+  double start = GetTime();
+  for (int i = 0; i < BULLET_BENCH_COUNT; i++) {
+    DrawCircleV(
+      bulletBenchPosition(i, width, height), BULLET_BENCH_RADIUS, YELLOW
+    );
+  }
+  rlDrawRenderBatchActive();
+  double fans = GetTime();
+  for (int i = 0; i < BULLET_BENCH_COUNT; i++) {
+    batch.drawCircle(
+      LAYER_BULLETS, bulletBenchPosition(i, width, height),
+      BULLET_BENCH_RADIUS, YELLOW
+    );
+  }
+  batch.flush();
+  rlDrawRenderBatchActive();
+  double quads = GetTime();
+
+  result.fanMs = (fans - start) * 1000.0;
+  result.quadMs = (quads - fans) * 1000.0;
+  return result;
+}
+
+#endif
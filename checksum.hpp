@@ -0,0 +1,44 @@
+#ifndef CHECKSUM
+#define CHECKSUM
+
+#include <cstdint>
+#include <cstring>
+
+#include "components.hpp"
+#include "entt.hpp"
+
+const uint64_t FNV_OFFSET_BASIS(14695981039346656037ull);
+const uint64_t FNV_PRIME(1099511628211ull);
+
+// FNV-1a over raw bytes, so two floats only hash the same if their bits match
+static uint64_t hashBytes(uint64_t hash, const void* data, const size_t size) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+// Checksum of the simulation state after a tick. Two runs with the same
+// inputs produce the same sequence of checksums only if every tick came out
+// bit-identical, which is what DETERMINISTIC_MATH builds should guarantee.
+static uint64_t stateChecksum(entt::registry& registry, const uint32_t tick) {
+  uint64_t hash = FNV_OFFSET_BASIS;
+  hash = hashBytes(hash, &tick, sizeof(tick));
+
+  for (auto e : registry.view<CharacterComponent>()) {
+    CharacterComponent& cc = registry.get<CharacterComponent>(e);
+    hash = hashBytes(hash, &e, sizeof(e));
+    hash = hashBytes(hash, &cc.position, sizeof(cc.position));
+    hash = hashBytes(hash, &cc.velocity, sizeof(cc.velocity));
+
+    MobComponent* mc = registry.try_get<MobComponent>(e);
+    if (mc) {
+      hash = hashBytes(hash, &mc->type, sizeof(mc->type));
+    }
+  }
+  return hash;
+}
+
+#endif
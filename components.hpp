@@ -3,14 +3,17 @@
 
 #include <raylib.h>
 
+#include <cstdint>
+
 #include "helper.hpp"
+#include "memtrack.hpp"
 
+// Touched by every tick for every character, keep it small and flat
 struct CharacterComponent {
   Vector2 position;
   Vector2 velocity;
 
-  float hitboxRadius;
-  std::vector<Vector2> unigridPositions;
+  float hitboxRadius;  // Read by every collision test and grid insert
 };
 
 struct meleeWeaponComponent {
@@ -29,10 +32,15 @@ const float ENEMY_SHOOT_INTERVAL_RAND(4.0f);
 const float BULLET_SPEED(300.0f);
 const float FRIENDLY_BULLET_SPEED_MULTIPLIER(1.5f);
 const int SCORE_PER_KILL(10);
-enum MobType { MELEE, RANGE, BULLET, FRIENDLY_BULLET };
+enum MobType : uint8_t { MELEE, RANGE, BULLET, FRIENDLY_BULLET };
+// Checked by nearly every loop, so it only holds the type
 struct MobComponent {
   MobType type;
-  Vector2 spawnPosition;
+};
+
+// Written once when a mob or bullet spawns and never read during a tick
+struct SpawnInfoComponent {
+  Vector2 position;
 };
 
 struct TimerComponent {
@@ -40,7 +48,7 @@ struct TimerComponent {
     ENEMY_SHOOT_INTERVAL_BASE - ENEMY_SHOOT_INTERVAL_RAND,
     ENEMY_SHOOT_INTERVAL_BASE + ENEMY_SHOOT_INTERVAL_RAND
   );
-  float timeLeft;
+  uint32_t dueTick;  // Tick on which the timer wheel fires this timer
 };
 
 struct StraightMovementComponent {
@@ -55,6 +63,21 @@ struct PlayerComponent {
   float hp;
 };
 
+// Per-type memory accounting, see memtrack.hpp
+TRACK_COMPONENT_MEMORY(CharacterComponent)
+TRACK_COMPONENT_MEMORY(MobComponent)
+TRACK_COMPONENT_MEMORY(SpawnInfoComponent)
+TRACK_COMPONENT_MEMORY(TimerComponent)
+TRACK_COMPONENT_MEMORY(StraightMovementComponent)
+TRACK_COMPONENT_MEMORY(ScoreOnKillComponent)
+
+// Mobs and bullets, the set that nearly every loop walks. The group owns both
+// storages, so their members sit packed at the front in the same order and
+// iterate without lookups. Neither storage can be sorted on its own.
+static auto mobGroup(entt::registry& registry) {
+  return registry.group<CharacterComponent, MobComponent>();
+}
+
 // Move towards a point
 static void moveTowards(
   CharacterComponent& c, const Vector2 targetPosition, const float timestep
@@ -112,7 +135,7 @@ static bool isWithinRectangle(const Vector2 position, const Rectangle limits) {
 static Vector2 clampToRectangle(
   const Vector2 position, const Rectangle limits
 ) {
-  Vector2 newPosition;
+  Vector2 newPosition = position;
   if (position.x < limits.x || position.x > limits.width) {
     newPosition.x = (position.x < limits.x) ? limits.x : limits.width;
   }
@@ -135,7 +158,9 @@ static void separateCharacters(CharacterComponent& a, CharacterComponent& b) {
 static bool charactersAreColliding(
   const CharacterComponent& a, const CharacterComponent& b
 ) {
-  float sumOfRadii(pow(a.hitboxRadius + b.hitboxRadius, 2));
+  float sumOfRadii(
+    (a.hitboxRadius + b.hitboxRadius) * (a.hitboxRadius + b.hitboxRadius)
+  );
   float distanceBetweenCenters(Vector2DistanceSqr(a.position, b.position));
 
   return (sumOfRadii >= distanceBetweenCenters);
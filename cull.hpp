@@ -0,0 +1,114 @@
+#ifndef CULL
+#define CULL
+
+#include <raylib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "arena.hpp"
+#include "components.hpp"
+#include "entt.hpp"
+#include "unigrid.hpp"
+
+// Furthest a sprite reaches from its entity's position, a rotated ranged
+// enemy. Less than a grid cell past the hitbox, so the grid's edge ring is
+// enough to find every sprite that can show.
+const float VIEW_CULL_MARGIN(70.0f);
+
+// Collects the mobs and bullets that can show in a view, from the grid cells
+// under it rather than from every character. The grid only covers the
+// window, a camera that leaves it needs the grid to grow with the world.
+struct ViewCuller {
+  // Drawn from until the next frame, taken from the frame arena. Kept
+  // between frames that run no tick, since the arena was not reset.
+  ArenaVector<entt::entity> visible;
+  uint32_t visibleGeneration;  // Arena generation the buffer came from
+  size_t reservedVisible = 0;
+  std::vector<uint32_t> seenOnPass;  // Indexed by entity, entities span cells
+  uint32_t pass = 0;
+
+  size_t lastVisible = 0;
+  size_t lastTotal = 0;
+
+  ViewCuller(FrameArena& arena)
+      : visible(ArenaAllocator<entt::entity>(&arena)),
+        visibleGeneration(arena.generation - 1) {}
+
+  void reserve(const size_t entities) {
+    reservedVisible = entities;
+    seenOnPass.reserve(entities);
+  }
+
+  // The grid holds the positions of the last tick, call before anything
+  // moves or is created. Destroyed entities are skipped.
+  void collect(
+    entt::registry& registry, const UniformGrid& unigrid, const Rectangle view
+  ) {
+    FrameArena& arena = *visible.get_allocator().arena;
+    if (visibleGeneration == arena.generation) {
+      visible.clear();
+    } else {
+      renewArenaVector(visible, reservedVisible);
+      visibleGeneration = arena.generation;
+    }
+    seenOnPass.resize(registry.size(), 0);
+    pass++;
+
+    Rectangle reach = {
+      view.x - VIEW_CULL_MARGIN, view.y - VIEW_CULL_MARGIN,
+      view.width + VIEW_CULL_MARGIN * 2.0f,
+      view.height + VIEW_CULL_MARGIN * 2.0f};
+    int rows = int(unigrid.cells.size());
+    int columns = rows ? int(unigrid.cells[0].size()) : 0;
+    float cellSize = float(unigrid.gridCellSize);
+    int firstColumn = std::max(0, int(std::floor(reach.x / cellSize)));
+    int firstRow = std::max(0, int(std::floor(reach.y / cellSize)));
+    int lastColumn = std::min(
+      columns - 1, int(std::floor((reach.x + reach.width) / cellSize))
+    );
+    int lastRow = std::min(
+      rows - 1, int(std::floor((reach.y + reach.height) / cellSize))
+    );
+
+    for (int row = firstRow; row <= lastRow; row++) {
+      for (int column = firstColumn; column <= lastColumn; column++) {
+        for (int32_t i = unigrid.cells[row][column].first;
+             i != UNIGRID_NONE; i = unigrid.entries[i].next) {
+          consider(registry, unigrid.entries[i].entity, reach);
+        }
+      }
+    }
+    // Only reachable when the view reaches past the grid
+    if (firstColumn == 0 || firstRow == 0 || lastColumn == columns - 1 ||
+        lastRow == rows - 1) {
+      for (size_t i = 0; i < unigrid.edgeObjects.size(); i++) {
+        consider(registry, unigrid.edgeObjects[i], reach);
+      }
+    }
+
+    lastVisible = visible.size();
+    lastTotal = registry.storage<MobComponent>().size();
+  }
+
+  void consider(
+    entt::registry& registry, const entt::entity e, const Rectangle& reach
+  ) {
+    // Checked first, a stale entry must not hide a live entity on its slot
+    if (!registry.valid(e)) return;
+    uint32_t& seen = seenOnPass[entt::to_entity(e)];
+    if (seen == pass) return;
+    seen = pass;
+    if (!registry.all_of<MobComponent>(e)) return;
+
+    Vector2 position = registry.get<CharacterComponent>(e).position;
+    if (position.x >= reach.x && position.x <= reach.x + reach.width &&
+        position.y >= reach.y && position.y <= reach.y + reach.height) {
+      visible.push_back(e);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef DET_MATH
+#define DET_MATH
+
+// Deterministic math for the simulation core.
+// Build with -DDETERMINISTIC_MATH (and -ffp-contract=off, without
+// -ffast-math) to replace the platform's transcendental functions with our
+// own approximations that only use +, -, *, / and comparisons. Those are
+// exactly specified by IEEE 754, so the simulation gives bit-identical
+// results between compilers and optimization levels. Without the define the
+// sim* functions forward to the standard library.
+//
+// A fused multiply-add rounds once where a * b + c rounds twice, so letting
+// the compiler contract expressions into FMAs changes results between
+// targets. Contraction is switched off below for everything defined after
+// this header, which is why main.cpp includes it before anything else, and
+// fast-math builds are refused.
+#ifdef DETERMINISTIC_MATH
+#if defined(__FAST_MATH__) || defined(_M_FP_FAST)
+#error "DETERMINISTIC_MATH can't be built with -ffast-math or /fp:fast"
+#endif
+#if defined(_M_FP_CONTRACT)
+#error "DETERMINISTIC_MATH can't be built with /fp:contract"
+#endif
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+#endif
+
+#include <raylib.h>
+#include <raymath.h>
+
+#include <cmath>
+
+// Only the sim* functions below call these, and only in deterministic builds
+#ifdef DETERMINISTIC_MATH
+const float DET_TWO_PI(2.0f * PI);
+const float DET_INV_TWO_PI(1.0f / (2.0f * PI));
+const float DET_HALF_PI(PI / 2.0f);
+
+// Sine, max error about 1e-6 for the angle range the game uses
+static float detSin(float x) {
+  // Reduce to [-pi, pi], then fold into [-pi/2, pi/2]
+  float k = floorf(x * DET_INV_TWO_PI + 0.5f);
+  x = x - k * DET_TWO_PI;
+  if (x > DET_HALF_PI) {
+    x = PI - x;
+  } else if (x < -DET_HALF_PI) {
+    x = -PI - x;
+  }
+
+  float x2 = x * x;
+  float result = -2.5052108e-8f;
+  result = result * x2 + 2.7557319e-6f;
+  result = result * x2 - 1.9841270e-4f;
+  result = result * x2 + 8.3333333e-3f;
+  result = result * x2 - 1.6666667e-1f;
+  result = result * x2 + 1.0f;
+  return result * x;
+}
+
+static float detCos(const float x) { return detSin(x + DET_HALF_PI); }
+
+// Arctangent for |x| <= 1, max error about 2e-6 radians
+static float detAtanUnit(const float x) {
+  float x2 = x * x;
+  float result = -0.01172120f;
+  result = result * x2 + 0.05265332f;
+  result = result * x2 - 0.11643287f;
+  result = result * x2 + 0.19354346f;
+  result = result * x2 - 0.33262347f;
+  result = result * x2 + 0.99997726f;
+  return result * x;
+}
+
+static float detAtan2(const float y, const float x) {
+  float absX = fabsf(x);
+  float absY = fabsf(y);
+  if (absX == 0.0f && absY == 0.0f) return 0.0f;
+
+  float angle = (absX >= absY) ? detAtanUnit(absY / absX)
+                               : DET_HALF_PI - detAtanUnit(absX / absY);
+  if (x < 0.0f) angle = PI - angle;
+  if (y < 0.0f) angle = -angle;
+  return angle;
+}
+#endif
+
+// --------------------------------------------------
+//                 SIMULATION MATH
+// --------------------------------------------------
+
+static float simSin(const float x) {
+#ifdef DETERMINISTIC_MATH
+  return detSin(x);
+#else
+  return sinf(x);
+#endif
+}
+
+static float simCos(const float x) {
+#ifdef DETERMINISTIC_MATH
+  return detCos(x);
+#else
+  return cosf(x);
+#endif
+}
+
+static float simAtan2(const float y, const float x) {
+#ifdef DETERMINISTIC_MATH
+  return detAtan2(y, x);
+#else
+  return atan2f(y, x);
+#endif
+}
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef EVENTS
+#define EVENTS
+
+#include <raylib.h>
+
+#include <cstring>
+#include <string>
+
+#include "entt.hpp"
+#include "uiHandler.hpp"
+
+// --------------------------------------------------
+//                 GAMEPLAY EVENTS
+// --------------------------------------------------
+// Emitted by the simulation into a per-tick queue and consumed once the
+// simulation step is done, so the hot loops never touch audio or UI.
+
+struct KillEvent {  // A mob was killed by the player
+  int score;
+};
+
+struct PlayerHitEvent {  // A mob reached the player
+  float hp;  // HP left after the hit
+};
+
+struct ShotEvent {  // A ranged enemy fired a bullet
+  Vector2 position;
+  Vector2 direction;
+};
+
+struct DeflectEvent {  // The player deflected a bullet
+  Vector2 position;
+  Vector2 direction;
+};
+
+// Scoring, audio and UI side of the gameplay events
+struct GameplayEventHandler {
+  int* score;
+  MenuHandler* menuHandler;
+  Sound bloodSplatter;
+
+  int mobsKilled = 0;
+  int shotsFired = 0;
+  int bulletsDeflected = 0;
+
+  bool playBloodSplatter = false;
+  bool playerDied = false;
+
+  void connect(entt::dispatcher& dispatcher) {
+    dispatcher.sink<KillEvent>().connect<&GameplayEventHandler::onKill>(*this);
+    dispatcher.sink<PlayerHitEvent>()
+      .connect<&GameplayEventHandler::onPlayerHit>(*this);
+    dispatcher.sink<ShotEvent>().connect<&GameplayEventHandler::onShot>(*this);
+    dispatcher.sink<DeflectEvent>()
+      .connect<&GameplayEventHandler::onDeflect>(*this);
+  }
+
+  void onKill(const KillEvent& event) {
+    *score += event.score;
+    mobsKilled++;
+    playBloodSplatter = true;
+  }
+
+  void onPlayerHit(const PlayerHitEvent& event) {
+    health = event.hp;
+    playBloodSplatter = true;
+    if (event.hp <= 0) {
+      playerDied = true;
+    }
+  }
+
+  void onShot(const ShotEvent&) { shotsFired++; }
+
+  void onDeflect(const DeflectEvent&) { bulletsDeflected++; }
+
+  // entt's queues have no reserve but keep their capacity when drained, so
+  // grow each one to count events up front. Only call with the queues empty.
+  void reserve(entt::dispatcher& dispatcher, const size_t count) {
+    reserveQueue<KillEvent>(dispatcher, count);
+    reserveQueue<PlayerHitEvent>(dispatcher, count);
+    reserveQueue<ShotEvent>(dispatcher, count);
+    reserveQueue<DeflectEvent>(dispatcher, count);
+  }
+
+  template <typename Event>
+  static void reserveQueue(entt::dispatcher& dispatcher, const size_t count) {
+    if (dispatcher.size<Event>() != 0) return;
+    for (size_t i = 0; i < count; i++) {
+      dispatcher.enqueue(Event{});
+    }
+    dispatcher.clear<Event>();
+  }
+
+  // Drain the queued events, scores first so game over sees the final score
+  void dispatch(entt::dispatcher& dispatcher) {
+    dispatcher.update<KillEvent>();
+    dispatcher.update<PlayerHitEvent>();
+    dispatcher.update<ShotEvent>();
+    dispatcher.update<DeflectEvent>();
+
+    // One splatter per frame no matter how many mobs died in it
+    if (playBloodSplatter) {
+      PlaySoundMulti(bloodSplatter);
+      playBloodSplatter = false;
+    }
+
+    if (playerDied) {
+      menuHandler->gameOverScreen.scoreLabel.text =
+        "SCORE: " + std::to_string(*score);
+      memset(
+        menuHandler->gameOverScreen.playerName.text, '\0',
+        sizeof(menuHandler->gameOverScreen.playerName.text)
+      );
+      menuHandler->gameOverScreen.playerName.letterCount = 0;
+      newScore = *score;
+      menuHandler->setState(InGameOverScreen);
+      playerDied = false;
+    }
+  }
+};
+
+#endif
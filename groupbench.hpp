@@ -0,0 +1,88 @@
+#ifndef GROUP_BENCH
+#define GROUP_BENCH
+
+#include <raylib.h>
+
+#include "components.hpp"
+#include "entt.hpp"
+#include "memtrack.hpp"
+#include "rollback.hpp"
+#include "timerwheel.hpp"
+
+const int GROUP_BENCH_PASSES(200);
+
+// Milliseconds per pass over every mob, for each way of iterating them
+struct GroupBenchResult {
+  size_t mobs;
+  double viewWithLookups;  // How the loops were written before the group
+  double view;
+  double nonOwningGroup;
+  double owningGroup;
+};
+
+// The memory traffic of the physics tick's mob loop without its logic
+static void groupBenchStep(CharacterComponent& cc, const MobComponent& mc) {
+  float scale = (mc.type == MELEE || mc.type == RANGE) ? 0.001f : 0.002f;
+  cc.position.x += cc.velocity.x * scale;
+  cc.position.y += cc.velocity.y * scale;
+}
+
+template <typename Pass>
+static double timeGroupBenchPasses(Pass pass) {
+  double start = GetTime();
+  for (int i = 0; i < GROUP_BENCH_PASSES; i++) {
+    pass();
+  }
+  return (GetTime() - start) * 1000.0 / GROUP_BENCH_PASSES;
+}
+
+// Runs each iteration style over its own copy of the world, so the game's
+// registry keeps its single owning group
+static GroupBenchResult benchmarkGroups(WorldSnapshot& world) {
+  ScratchMemoryScope scratchMemory;  // Outlives the copies
+  GroupBenchResult result;
+  TimerWheel scratchWheel;
+
+  {
+    entt::registry registry;
+    world.restore(registry, scratchWheel);
+    result.mobs = registry.view<CharacterComponent, MobComponent>().size_hint();
+
+    result.viewWithLookups = timeGroupBenchPasses([&registry]() {
+      for (auto e : registry.view<CharacterComponent>()) {
+        CharacterComponent& cc = registry.get<CharacterComponent>(e);
+        MobComponent* mc = registry.try_get<MobComponent>(e);
+        if (mc) groupBenchStep(cc, *mc);
+      }
+    });
+    result.view = timeGroupBenchPasses([&registry]() {
+      for (auto [e, cc, mc] :
+           registry.view<CharacterComponent, MobComponent>().each()) {
+        groupBenchStep(cc, mc);
+      }
+    });
+
+    auto group =
+      registry.group<>(entt::get<CharacterComponent, MobComponent>);
+    result.nonOwningGroup = timeGroupBenchPasses([&group]() {
+      for (auto [e, cc, mc] : group.each()) {
+        groupBenchStep(cc, mc);
+      }
+    });
+  }
+
+  {
+    entt::registry registry;
+    auto group = mobGroup(registry);
+    world.restore(registry, scratchWheel);
+    result.owningGroup = timeGroupBenchPasses([&group]() {
+      for (auto [e, cc, mc] : group.each()) {
+        groupBenchStep(cc, mc);
+      }
+    });
+  }
+
+  return result;
+}
+
+#endif
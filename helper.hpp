@@ -4,9 +4,11 @@
 #include <raylib.h>
 #include <raymath.h>
 #include <climits>
+#include <cstdint>
 #include <cstdlib>
 
 #include "components.hpp"
+#include "detmath.hpp"
 
 enum State {
 	InMainMenu = 0,
@@ -16,17 +18,35 @@ enum State {
 	InGame = 4
 };
 
+// xorshift64* generator, used instead of rand() so its state can be saved
+struct Random {
+  uint64_t state = 88172645463325252ull;
+
+  void seed(const uint64_t value) {
+    state = value ? value : 88172645463325252ull;  // Must never be zero
+  }
+
+  uint32_t next() {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return static_cast<uint32_t>((state * 2685821657736338717ull) >> 32);
+  }
+};
+
+inline Random gameRandom;
+
 // https://cplusplus.com/forum/beginner/81180/
 // Returns a random float within min and max
 static float randf(const float min, const float max) {
-  float result = (rand() / static_cast<float>(RAND_MAX) * (max + 1)) + min;
+  float result = (gameRandom.next() / static_cast<float>(UINT32_MAX) * (max + 1)) + min;
   return result;
 }
 
 // RNG 0-100
 static bool rng(const int chance) {
   if (chance >= 100) return true;
-  int randomNumber = rand() % 100;
+  int randomNumber = gameRandom.next() % 100;
   if (randomNumber < chance) {
     return true;
   }
@@ -39,8 +59,8 @@ static Vector2 chooseSpawnPosition(
 ) {
   // Select random Vector2 inside window
   Vector2 randomPosition = {
-    static_cast<float>(rand() % windowWidth),
-    static_cast<float>(rand() % windowHeight)};
+    static_cast<float>(gameRandom.next() % windowWidth),
+    static_cast<float>(gameRandom.next() % windowHeight)};
 
   bool spawnOnLeftOrRight = rng(50);
 
@@ -65,7 +85,7 @@ float findRotationAngle(
   Vector2 characterPos, Vector2 mousePos
 ) {
   float resultAngle;
-  resultAngle = atan2f(mousePos.y - characterPos.y, mousePos.x - characterPos.x);
+  resultAngle = simAtan2(mousePos.y - characterPos.y, mousePos.x - characterPos.x);
   return resultAngle;
 }
 
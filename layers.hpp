@@ -0,0 +1,100 @@
+#ifndef LAYERS
+#define LAYERS
+
+#include <raylib.h>
+#include <rlgl.h>
+
+#include <cstdint>
+
+// Screen layers that change far less often than every frame
+enum ScreenLayer {
+  SCREEN_LAYER_FLOOR,  // Under the game world
+  SCREEN_LAYER_HUD,  // Over the game world
+  SCREEN_LAYER_FROZEN,  // The whole game world, while paused
+  SCREEN_LAYER_COUNT
+};
+
+const char* SCREEN_LAYER_NAMES[SCREEN_LAYER_COUNT] = {
+  "floor", "HUD", "frozen frame"};
+
+// A layer's content kept in a render texture. It is drawn again only after
+// being marked dirty, every other frame it is one textured quad.
+struct CachedLayer {
+  RenderTexture2D target = {};
+  Rectangle bounds = {};  // Screen area, the texture is drawn 1:1 into it
+  bool dirty = true;
+
+  uint32_t renders = 0;  // Since loaded
+  uint32_t windowRenders = 0;  // In the current second
+  uint32_t lastSecondRenders = 0;
+};
+
+// Keeps the cached screen layers and counts how often each is re-rendered.
+// Layers are rendered between frames, call update before BeginDrawing.
+struct LayerCompositor {
+  CachedLayer layers[SCREEN_LAYER_COUNT];
+  double windowStart = 0.0;
+  uint32_t windowFrames = 0;
+  uint32_t lastSecondFrames = 0;
+
+  void load(const ScreenLayer layer, const Rectangle bounds) {
+    CachedLayer& cached = layers[layer];
+    cached.target = LoadRenderTexture(int(bounds.width), int(bounds.height));
+    cached.bounds = bounds;
+    cached.dirty = true;
+  }
+
+  void unload() {
+    for (int i = 0; i < SCREEN_LAYER_COUNT; i++) {
+      if (layers[i].target.id != 0) UnloadRenderTexture(layers[i].target);
+      layers[i] = {};
+    }
+  }
+
+  void markDirty(const ScreenLayer layer) { layers[layer].dirty = true; }
+
+  // Re-renders a dirty layer with draw, which draws in screen coordinates
+  // as if the layer were the screen
+  template <typename DrawFunction>
+  void update(const ScreenLayer layer, DrawFunction draw) {
+    CachedLayer& cached = layers[layer];
+    if (!cached.dirty) return;
+
+    BeginTextureMode(cached.target);
+    ClearBackground(BLANK);
+    rlPushMatrix();
+    rlTranslatef(-cached.bounds.x, -cached.bounds.y, 0.0f);
+    draw();
+    rlPopMatrix();
+    EndTextureMode();
+
+    cached.dirty = false;
+    cached.renders++;
+    cached.windowRenders++;
+  }
+
+  void draw(const ScreenLayer layer) const {
+    const CachedLayer& cached = layers[layer];
+    // Render textures are stored bottom up, the source is flipped
+    DrawTextureRec(
+      cached.target.texture,
+      {0.0f, 0.0f, cached.bounds.width, -cached.bounds.height},
+      {cached.bounds.x, cached.bounds.y}, WHITE
+    );
+  }
+
+  // Rolls the re-render counts over once a second
+  void endFrame(const double now) {
+    windowFrames++;
+    if (now - windowStart < 1.0) return;
+    for (int i = 0; i < SCREEN_LAYER_COUNT; i++) {
+      layers[i].lastSecondRenders = layers[i].windowRenders;
+      layers[i].windowRenders = 0;
+    }
+    lastSecondFrames = windowFrames;
+    windowFrames = 0;
+    windowStart = now;
+  }
+};
+
+#endif
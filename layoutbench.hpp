@@ -0,0 +1,152 @@
+#ifndef LAYOUT_BENCH
+#define LAYOUT_BENCH
+
+#include <raylib.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "components.hpp"
+#include "entt.hpp"
+#include "memtrack.hpp"
+#include "rollback.hpp"
+#include "timerwheel.hpp"
+#include "unigrid.hpp"
+
+const int LAYOUT_BENCH_PASSES(200);
+const float LAYOUT_BENCH_CELL_SIZE(60.0f);  // Same as the collision grid
+
+// The character and mob components as they were before the cold data was
+// split out: the grid cells lived in the character, the spawn position in
+// the mob, and the mob type was a full int
+struct UnsplitCharacterComponent {
+  Vector2 position;
+  Vector2 velocity;
+  float hitboxRadius;
+  std::vector<Vector2> unigridPositions;
+};
+
+struct UnsplitMobComponent {
+  int type;
+  Vector2 spawnPosition;
+};
+
+// Component bytes one pass over every mob touches, and milliseconds per pass
+struct LayoutBenchResult {
+  size_t mobs;
+  size_t unsplitBytes;
+  size_t splitBytes;
+  double unsplit;
+  double split;
+};
+
+// The tick's per-mob work on the character and mob data: check the type and
+// move, then find the grid cells the hitbox covers
+static void layoutBenchMove(
+  Vector2& position, const Vector2 velocity, const int type
+) {
+  float scale = (type == MELEE || type == RANGE) ? 0.001f : 0.002f;
+  position.x += velocity.x * scale;
+  position.y += velocity.y * scale;
+}
+
+static void layoutBenchCells(
+  const Vector2 position, const float hitboxRadius, Vector2& min, Vector2& max
+) {
+  min = convertToUnigridPosition(
+    {position.x - hitboxRadius, position.y + hitboxRadius},
+    LAYOUT_BENCH_CELL_SIZE
+  );
+  max = convertToUnigridPosition(
+    {position.x + hitboxRadius, position.y - hitboxRadius},
+    LAYOUT_BENCH_CELL_SIZE
+  );
+}
+
+// Keeps the benchmark's sums alive without printing them
+static volatile uint32_t layoutBenchSink;
+
+template <typename Pass>
+static double timeLayoutBenchPasses(Pass pass) {
+  double start = GetTime();
+  for (int i = 0; i < LAYOUT_BENCH_PASSES; i++) {
+    pass();
+  }
+  return (GetTime() - start) * 1000.0 / LAYOUT_BENCH_PASSES;
+}
+
+// Runs the same per-mob work over the current components and over the
+// unsplit ones they replaced, each in its own copy of the world
+static LayoutBenchResult benchmarkLayouts(WorldSnapshot& world) {
+  ScratchMemoryScope scratchMemory;  // Outlives the copies
+  LayoutBenchResult result;
+  TimerWheel scratchWheel;
+  uint32_t sink = 0;
+
+  entt::registry split;
+  world.restore(split, scratchWheel);
+  auto splitView = split.view<CharacterComponent, MobComponent>();
+
+  entt::registry unsplit;
+  for (auto [e, cc, mc] : splitView.each()) {
+    entt::entity copy = unsplit.create(e);
+    UnsplitCharacterComponent& ucc =
+      unsplit.emplace<UnsplitCharacterComponent>(copy);
+    ucc.position = cc.position;
+    ucc.velocity = cc.velocity;
+    ucc.hitboxRadius = cc.hitboxRadius;
+    SpawnInfoComponent* spawn = split.try_get<SpawnInfoComponent>(e);
+    unsplit.emplace<UnsplitMobComponent>(
+      copy, int(mc.type), spawn ? spawn->position : Vector2Zero()
+    );
+  }
+  auto unsplitView =
+    unsplit.view<UnsplitCharacterComponent, UnsplitMobComponent>();
+
+  // Cells are summed so the work is not optimized away
+  result.split = timeLayoutBenchPasses([&]() {
+    for (auto [e, cc, mc] : splitView.each()) {
+      layoutBenchMove(cc.position, cc.velocity, mc.type);
+      Vector2 min, max;
+      layoutBenchCells(cc.position, cc.hitboxRadius, min, max);
+      for (int x = min.x; x <= max.x; x++) {
+        for (int y = min.y; y >= max.y; y--) {
+          sink += uint32_t(x + y);
+        }
+      }
+    }
+  });
+
+  // The cells went through the character's vector on their way into the
+  // grid, as refreshUnigridPositions used to do
+  result.unsplit = timeLayoutBenchPasses([&]() {
+    for (auto [e, cc, mc] : unsplitView.each()) {
+      layoutBenchMove(cc.position, cc.velocity, mc.type);
+      Vector2 min, max;
+      layoutBenchCells(cc.position, cc.hitboxRadius, min, max);
+      cc.unigridPositions.clear();
+      for (int x = min.x; x <= max.x; x++) {
+        for (int y = min.y; y >= max.y; y--) {
+          cc.unigridPositions.push_back({float(x), float(y)});
+        }
+      }
+      for (size_t i = 0; i < cc.unigridPositions.size(); i++) {
+        sink += uint32_t(cc.unigridPositions[i].x + cc.unigridPositions[i].y);
+      }
+    }
+  });
+
+  result.mobs = splitView.size_hint();
+  result.splitBytes =
+    result.mobs * (sizeof(CharacterComponent) + sizeof(MobComponent));
+  result.unsplitBytes = result.mobs * (sizeof(UnsplitCharacterComponent) +
+                                       sizeof(UnsplitMobComponent));
+  for (auto [e, cc] : unsplit.storage<UnsplitCharacterComponent>().each()) {
+    result.unsplitBytes += cc.unigridPositions.capacity() * sizeof(Vector2);
+  }
+
+  layoutBenchSink = sink;
+  return result;
+}
+
+#endif
@@ -1,13 +1,40 @@
+// First, so DETERMINISTIC_MATH builds turn off floating point contraction
+// before any header defines math
+#include "detmath.hpp"
+
 #include <raylib.h>
 #include <raymath.h>
 #include <string.h>
 
+#include <fstream>
 #include <iostream>
+#include <ctime>
 #include <string>
 #include <vector>
 
+#include "ailod.hpp"
+#include "alloctrack.hpp"
+#include "arena.hpp"
+#include "atlas.hpp"
+#include "bulletbench.hpp"
+#include "checksum.hpp"
 #include "components.hpp"
+#include "cull.hpp"
 #include "entt.hpp"
+#include "events.hpp"
+#include "groupbench.hpp"
+#include "layers.hpp"
+#include "layoutbench.hpp"
+#include "overlay.hpp"
+#include "pipeline.hpp"
+#include "replay.hpp"
+#include "rollback.hpp"
+#include "snapshot.hpp"
+#include "spatialsort.hpp"
+#include "spawnbatch.hpp"
+#include "spritebatch.hpp"
+#include "stats.hpp"
+#include "timerwheel.hpp"
 #include "uiHandler.hpp"
 #include "unigrid.hpp"
 
@@ -21,10 +48,58 @@ const char* WINDOW_TITLE("⚔ HAKENSLASH ⚔");
 
 const int TARGET_FPS(60);
 const float TIMESTEP(1.0f / TARGET_FPS);
+// Pause and the other menus only animate the cursor and button hovers
+const int MENU_FPS(30);
+
+// The batch upload paths live in the vendored raylib sources, the prebuilt
+// libraylib.a does not have them. Builds linking raylib rebuilt from
+// ./raylib define VENDORED_RAYLIB to use them.
+#if (defined(BATCH_UPLOAD_MODE) || defined(BATCH_VERTEX_FORMAT)) && \
+  !defined(VENDORED_RAYLIB)
+#error "BATCH_UPLOAD_MODE and BATCH_VERTEX_FORMAT need VENDORED_RAYLIB"
+#endif
+#if defined(VENDORED_RAYLIB) && !defined(BATCH_VERTEX_FORMAT)
+// raylib's config.h keeps the default vertex layout. The game only draws 2D
+// without depth testing, and its texcoords stay inside the textures, so it
+// turns on the compact one. -DBATCH_VERTEX_FORMAT=0 switches it back off.
+#define BATCH_VERTEX_FORMAT RL_BATCH_VERTEX_2D
+#endif
+#ifdef BATCH_UPLOAD_MODE
+// Upload path comparisons run uncapped, so EndDrawing times the flush and
+// the buffer swap rather than the frame limiter's wait
+const bool UNCAPPED_FPS(true);
+#else
+const bool UNCAPPED_FPS(false);
+#endif
 
 const KeyboardKey PAUSE_KEY(KEY_TAB);
+const KeyboardKey DEBUG_OVERLAY_KEY(KEY_F3);
+const KeyboardKey QUICK_SAVE_KEY(KEY_F5);
+const KeyboardKey QUICK_LOAD_KEY(KEY_F9);
+const KeyboardKey AUTOSAVE_LOAD_KEY(KEY_F10);
+const KeyboardKey GROUP_BENCHMARK_KEY(KEY_F6);
+const KeyboardKey ROLLBACK_BENCHMARK_KEY(KEY_F7);
+const KeyboardKey BULLET_BENCHMARK_KEY(KEY_F8);
+const KeyboardKey ALLOCATION_LOG_KEY(KEY_F4);
+const KeyboardKey LAYOUT_BENCHMARK_KEY(KEY_F2);
+#ifdef ZERO_ALLOCATION_TICKS
+const KeyboardKey ZERO_ALLOCATION_CHECK_KEY(KEY_F11);
+#endif
+
+const char* QUICK_SAVE_PATH("quicksave.bin");
+const char* AUTOSAVE_PATH("autosave.bin");
+const float AUTOSAVE_INTERVAL(30.0f);  // Seconds of play between autosaves
+const char* ALLOCATION_LOG_PATH("allocations.csv");
+
+#ifdef ZERO_ALLOCATION_TICKS
+// Ticks after the first wave before ticks may no longer allocate, long enough
+// for every buffer the simulation reuses to reach its working size
+const uint32_t ZERO_ALLOCATION_WARMUP_TICKS(120);
+const int ZERO_ALLOCATION_CHECK_TICKS(5000);  // About 83 s of play
+#endif
 
 const float UNIGRID_CELL_SIZE(60.0f);
+const float MOB_HITBOX_RADIUS(45.0f);  // Largest hitbox in the grid
 
 const float WAIT_TIME_BEFORE_FIRST_SPAWN(1.0f);
 const int BASE_ENEMY_COUNT(5);
@@ -35,10 +110,24 @@ const float ENEMY_SPEEDUP_ADDER(10.0f);
 
 const float PLAYER_MOVESPEED(180.0f);
 
+#ifdef DETERMINISTIC_MATH
+const unsigned int DETERMINISTIC_SEED(1);
+const char* CHECKSUM_LOG_PATH("checksums.txt");
+const char* INPUT_LOG_PATH("inputs.bin");
+const char* REPLAY_ARGUMENT("--replay");
+#endif
+
+// Convert a duration in seconds to a whole number of physics ticks
+static uint32_t secondsToTicks(const float seconds) {
+  return static_cast<uint32_t>(ceil(seconds / TIMESTEP));
+}
+
 static bool checkCharacterCollision(
   const CharacterComponent& a, const CharacterComponent& b
 ) {
-  float sumOfRadii(pow(a.hitboxRadius + b.hitboxRadius, 2));
+  float sumOfRadii(
+    (a.hitboxRadius + b.hitboxRadius) * (a.hitboxRadius + b.hitboxRadius)
+  );
   float distanceBetweenCenters(Vector2DistanceSqr(a.position, b.position));
 
   return (sumOfRadii >= distanceBetweenCenters);
@@ -47,45 +136,365 @@ static bool checkCharacterCollision(
 static bool checkWeaponCollision(
   const meleeWeaponComponent& a, const CharacterComponent& b
 ) {
-  float sumOfRadii(pow(a.hitboxRadius + b.hitboxRadius, 2));
+  float sumOfRadii(
+    (a.hitboxRadius + b.hitboxRadius) * (a.hitboxRadius + b.hitboxRadius)
+  );
   float distanceBetweenCenters(Vector2DistanceSqr(a.position, b.position));
 
   return (sumOfRadii >= distanceBetweenCenters);
 }
 
-static void spawnEnemies(entt::registry& registry, const int amount, const int speedLevel) {
-  for (int i = 0; i < amount; i++) {
-    entt::entity e = registry.create();
+static void spawnEnemies(entt::registry& registry, FrameArena& frameArena, TimerWheel& timerWheel, AILodScheduler& aiLod, const int amount, const int speedLevel) {
+  SpawnBatch batch(frameArena);
+  batch.reserve(amount);
+  reserveForWave(registry, amount);
 
-    CharacterComponent& cc = registry.emplace<CharacterComponent>(e);
-    MobComponent& mc = registry.emplace<MobComponent>(e);
-    ScoreOnKillComponent& sokc = registry.emplace<ScoreOnKillComponent>(e);
-    mc.type = (rng(80)) ? MELEE : RANGE;
-    mc.spawnPosition =
+  for (int i = 0; i < amount; i++) {
+    // Mob type is set on insert so the stats counters see it
+    MobType type = (rng(80)) ? MELEE : RANGE;
+    Vector2 spawnPosition =
       chooseSpawnPosition(WINDOW_WIDTH, WINDOW_HEIGHT, SPAWN_OFFSET);
-    cc.hitboxRadius = 45.0f;
-    cc.position = mc.spawnPosition;
-    if (mc.type == MELEE) {
+
+    CharacterComponent cc;
+    cc.hitboxRadius = MOB_HITBOX_RADIUS;
+    cc.position = spawnPosition;
+    if (type == MELEE) {
       cc.velocity = {
         randf(ENEMY_MELEE_VELOCITY_MIN, ENEMY_MELEE_VELOCITY_MAX),
         randf(ENEMY_MELEE_VELOCITY_MIN, ENEMY_MELEE_VELOCITY_MAX)};
-    } else if (mc.type == RANGE) {
+    } else if (type == RANGE) {
       cc.velocity = {
         randf(ENEMY_RANGE_VELOCITY_MIN, ENEMY_RANGE_VELOCITY_MAX),
         randf(ENEMY_RANGE_VELOCITY_MIN, ENEMY_RANGE_VELOCITY_MAX)};
-      TimerComponent& tc = registry.emplace<TimerComponent>(e);
+      TimerComponent tc;
       tc.maxTime = randf(
         ENEMY_SHOOT_INTERVAL_BASE - ENEMY_SHOOT_INTERVAL_RAND,
         ENEMY_SHOOT_INTERVAL_BASE + ENEMY_SHOOT_INTERVAL_RAND
       );
-      tc.timeLeft = tc.maxTime;
+      tc.dueTick = timerWheel.currentTick + secondsToTicks(tc.maxTime);
+      batch.timedIndices.push_back(batch.size());
+      batch.timers.push_back(tc);
     }
 		cc.velocity = Vector2AddValue(cc.velocity, speedLevel * ENEMY_SPEEDUP_ADDER);
+
+    AILodComponent lod;
+    aiLod.assign(lod);
+
+    batch.characters.push_back(cc);
+    batch.mobs.push_back({type});
+    batch.spawns.push_back({spawnPosition});
+    batch.lods.push_back(lod);
   }
+
+  batch.commit(registry, timerWheel);
 }
 
-int main() {
-  srand(GetTime());
+// PHYSICS TICK
+// Each system is one step of the fixed physics tick and lists the data it
+// reads and writes, see pipeline.hpp
+
+struct SwingState {};  // Stands for the canSwing and isAttacking flags
+
+// Everything a physics tick works on
+struct TickContext {
+  entt::registry& registry;
+  TimerWheel& timerWheel;
+  AILodScheduler& aiLod;
+  UniformGrid& unigrid;
+  entt::dispatcher& dispatcher;
+  FrameArena& frameArena;
+  SpatialSorter& spatialSorter;
+  const TickInput& input;
+  entt::entity playerEntity;
+  entt::entity weaponEntity;
+  entt::entity weaponAnimationEntity;
+  bool& canSwing;
+  bool& isAttacking;
+};
+
+struct ClearScratchSystem {
+  using reads = Reads<>;
+  using writes = Writes<UniformGrid, FrameArena>;
+
+  static void run(TickContext& context) {
+    context.frameArena.reset();
+    context.unigrid.clearCells();  // Its pool lives in the arena
+  }
+};
+
+struct SpatialSortSystem {
+  using reads = Reads<TimerWheel>;
+  using writes = Writes<
+    SpatialSorter, CharacterComponent, MobComponent, AILodComponent,
+    StraightMovementComponent>;
+
+  static void run(TickContext& context) {
+    context.spatialSorter.update(
+      context.registry, context.timerWheel.currentTick
+    );
+  }
+};
+
+struct PlayerMovementSystem {
+  using reads = Reads<TickInput>;
+  using writes = Writes<CharacterComponent>;
+
+  static void run(TickContext& context) {
+    CharacterComponent& playerCc =
+      context.registry.get<CharacterComponent>(context.playerEntity);
+    playerCc.position = Vector2Add(
+      playerCc.position,
+      Vector2Scale(context.input.moveDirection, PLAYER_MOVESPEED * TIMESTEP)
+    );
+    playerCc.position = clampToRectangle(
+      playerCc.position,
+      {20.0f, 120.0f, WINDOW_WIDTH - 20.0f, WINDOW_HEIGHT - 20.0f}
+    );
+  }
+};
+
+struct AILodFocusSystem {
+  using reads = Reads<CharacterComponent>;
+  using writes = Writes<AILodScheduler>;
+
+  static void run(TickContext& context) {
+    context.aiLod.beginTick(
+      context.registry.get<CharacterComponent>(context.playerEntity).position,
+      {0.0f, 0.0f, WINDOW_WIDTH, WINDOW_HEIGHT}
+    );
+  }
+};
+
+// Weapon Hitbox Tracking
+struct WeaponTrackingSystem {
+  using reads = Reads<CharacterComponent, TickInput>;
+  using writes = Writes<meleeWeaponComponent>;
+
+  static void run(TickContext& context) {
+    const CharacterComponent& playerCc =
+      context.registry.get<CharacterComponent>(context.playerEntity);
+    meleeWeaponComponent& wc =
+      context.registry.get<meleeWeaponComponent>(context.weaponEntity);
+    wc.position = Vector2Add(
+      playerCc.position, Vector2Scale(
+                           Vector2Normalize(Vector2Subtract(
+                             context.input.aimPosition, playerCc.position
+                           )),
+                           SWORD_REACH
+                         )
+    );
+  }
+};
+
+struct TimerSystem {
+  using reads = Reads<>;
+  using writes = Writes<
+    entt::registry, TimerWheel, TimerComponent, CharacterComponent,
+    MobComponent, SpawnInfoComponent, StraightMovementComponent, FrameArena,
+    entt::dispatcher, SwingState>;
+
+  static void run(TickContext& context) {
+    entt::registry& registry = context.registry;
+    TimerWheel& timerWheel = context.timerWheel;
+    entt::dispatcher& dispatcher = context.dispatcher;
+    const CharacterComponent player =
+      registry.get<CharacterComponent>(context.playerEntity);
+
+    // Timers (swing cooldown, attack animation, ranged enemy shots)
+    // Only the timers expiring on this tick are visited
+    ArenaVector<entt::entity> expiredTimers{
+      ArenaAllocator<entt::entity>(&context.frameArena)};
+    timerWheel.advance(expiredTimers);
+    for (auto e : expiredTimers) {
+      if (!registry.valid(e)) continue;
+      TimerComponent* tc = registry.try_get<TimerComponent>(e);
+      if (!tc || tc->dueTick != timerWheel.currentTick) continue;
+
+      if (e == context.weaponEntity) {
+        context.canSwing = true;
+      } else if (e == context.weaponAnimationEntity) {
+        context.isAttacking = false;
+      } else {
+        CharacterComponent* cc = registry.try_get<CharacterComponent>(e);
+        if (!cc) continue;
+
+        // Create and shoot bullet
+        // The character is filled in before the bullet joins the mob group,
+        // joining moves it within its storage
+        entt::entity bulletEntity = registry.create();
+        CharacterComponent bulletCc;
+        bulletCc.hitboxRadius = 5.0f;
+        bulletCc.position = cc->position;
+        bulletCc.velocity = {BULLET_SPEED, BULLET_SPEED};
+        registry.emplace<CharacterComponent>(bulletEntity, bulletCc);
+        registry.emplace<MobComponent>(bulletEntity, BULLET);
+        registry.emplace<SpawnInfoComponent>(bulletEntity, cc->position);
+        StraightMovementComponent& smc =
+          registry.emplace<StraightMovementComponent>(bulletEntity);
+        smc.direction =
+          Vector2Normalize(Vector2Subtract(player.position, cc->position));
+        dispatcher.enqueue<ShotEvent>(cc->position, smc.direction);
+
+        tc->dueTick = timerWheel.currentTick + secondsToTicks(tc->maxTime);
+        timerWheel.schedule(e, tc->dueTick);
+      }
+    }
+  }
+};
+
+struct MobSystem {
+  using reads = Reads<StraightMovementComponent, ScoreOnKillComponent>;
+  using writes = Writes<
+    entt::registry, CharacterComponent, MobComponent, AILodComponent,
+    AILodScheduler, UniformGrid, PlayerComponent, entt::dispatcher>;
+
+  static void run(TickContext& context) {
+    entt::registry& registry = context.registry;
+    AILodScheduler& aiLod = context.aiLod;
+    UniformGrid& unigrid = context.unigrid;
+    entt::dispatcher& dispatcher = context.dispatcher;
+    const CharacterComponent player =
+      registry.get<CharacterComponent>(context.playerEntity);
+
+    // Mobs and bullets, the player only goes through the collisions and the
+    // grid. Collisions are resolved once per character, as before.
+    auto resolveMobCollisions = [&]() {
+      // Mob collisions
+      // Check collision with other mobs
+      for (size_t i = 0; i < unigrid.cells.size(); i++) {
+        for (size_t j = 0; j < unigrid.cells[i].size(); j++) {
+          const Cell& cell = unigrid.cells[i][j];
+          for (int32_t obj1 = cell.first; obj1 != UNIGRID_NONE;
+               obj1 = unigrid.entries[obj1].next) {
+            for (int32_t obj2 = cell.first; obj2 != UNIGRID_NONE;
+                 obj2 = unigrid.entries[obj2].next) {
+              if (obj1 == obj2) continue;
+
+              entt::entity eA = unigrid.entries[obj1].entity;
+              entt::entity eB = unigrid.entries[obj2].entity;
+
+              if (!registry.valid(eA) || !registry.valid(eB)) continue;
+
+              // Don't collide with player
+              if (registry.try_get<PlayerComponent>(eA) || registry.try_get<PlayerComponent>(eB))
+                continue;
+
+              MobComponent* aMc = registry.try_get<MobComponent>(eA);
+              MobComponent* bMc = registry.try_get<MobComponent>(eB);
+
+              // Don't collide with bullets
+              if (aMc->type == BULLET || bMc->type == BULLET) continue;
+
+              CharacterComponent* aCc =
+                registry.try_get<CharacterComponent>(eA);
+              CharacterComponent* bCc =
+                registry.try_get<CharacterComponent>(eB);
+
+              if (charactersAreColliding(*aCc, *bCc)) {
+                ScoreOnKillComponent* aSokc =
+                  registry.try_get<ScoreOnKillComponent>(eA);
+                // Collide with friendly bullets
+                if (bMc->type == FRIENDLY_BULLET) {
+                  dispatcher.enqueue<KillEvent>(aSokc ? aSokc->score : 0);
+                  registry.destroy(eA);
+                } else {
+                  separateCharacters(*aCc, *bCc);
+                }
+              }
+            }
+          }
+        }
+      }
+    };
+
+    for (auto [e, cc, mc] : mobGroup(registry).each()) {
+      StraightMovementComponent* smc =
+        registry.try_get<StraightMovementComponent>(e);
+
+      if (smc) {
+        moveDirectional(cc, smc->direction, TIMESTEP);
+        // Destroy SMC if it's not visible anymore
+        if (!isWithinRectangle(
+              cc.position, {0.0f, 0.0f, WINDOW_WIDTH, WINDOW_HEIGHT}
+            )) {
+          registry.destroy(e);
+        }
+      }
+
+      // Move mobs
+      // Mobs away from the player steer at a reduced rate
+      switch (mc.type) {
+        case MELEE:
+          steerWithLod(
+            aiLod, registry.get<AILodComponent>(e), cc, TIMESTEP,
+            [&](CharacterComponent& c) {
+              moveTowards(c, player.position, TIMESTEP);
+            }
+          );
+          break;
+        case RANGE:
+          steerWithLod(
+            aiLod, registry.get<AILodComponent>(e), cc, TIMESTEP,
+            [&](CharacterComponent& c) {
+              moveTowardsWithSlowOnLimit(
+                c, player.position, ENEMY_RANGE_SAFE_DISTANCE, TIMESTEP
+              );
+            }
+          );
+          break;
+        default:
+          break;
+      }
+
+      // Destroy character if it collides with player
+      if (charactersAreColliding(player, cc)) {
+        PlayerComponent& pc =
+          registry.get<PlayerComponent>(context.playerEntity);
+        registry.destroy(e);
+        pc.hp -= 1;
+        dispatcher.enqueue<PlayerHitEvent>(pc.hp);
+      }
+
+      resolveMobCollisions();
+      unigrid.insert(e, cc);
+    }
+
+    resolveMobCollisions();
+    unigrid.insert(context.playerEntity, player);
+  }
+};
+
+// Systems within a stage touch disjoint data
+using TickPipeline = Pipeline<
+  Stage<ClearScratchSystem, SpatialSortSystem>,
+  Stage<PlayerMovementSystem>,
+  Stage<AILodFocusSystem, WeaponTrackingSystem>,
+  Stage<TimerSystem>,
+  Stage<MobSystem>>;
+
+int main(int argc, char** argv) {
+  // Deterministic builds record the inputs of the first run to
+  // INPUT_LOG_PATH. Launched with "--replay <file>" they play a recording
+  // back instead of reading the keyboard and mouse, starting straight in the
+  // game and quitting when the recording or the run ends. Diff the checksum
+  // logs of two builds replaying the same file to compare them.
+  InputRecorder inputRecorder;
+  InputReplay inputReplay;
+  bool replaying(false);
+#ifdef DETERMINISTIC_MATH
+  replaying = argc == 3 && strcmp(argv[1], REPLAY_ARGUMENT) == 0;
+  if (replaying && !inputReplay.load(argv[2])) {
+    std::cout << "Could not load " << argv[2] << std::endl;
+    return 1;
+  }
+  gameRandom.seed(replaying ? inputReplay.seed : DETERMINISTIC_SEED);
+  std::ofstream checksumLog(CHECKSUM_LOG_PATH, std::ofstream::trunc);
+  bool recordedRun(replaying);
+#else
+  (void)argc;
+  (void)argv;
+  gameRandom.seed(time(nullptr));
+#endif
 
   State state;
 
@@ -99,11 +508,32 @@ int main() {
 	int timesEnemiesSpawned(0);
 	int timesEnemiesSpedUp(0);
 
-  bool isAttacking;
+  bool isAttacking(false);
+  bool showDebugOverlay(false);
+  double batchFlushMs(0.0);  // Running average of the end of frame upload
+  double endDrawingMs(0.0);  // Same, for the upload and all of EndDrawing
+  std::ofstream allocationLog;  // Per-frame heap allocations while open
+  int loggedFrames(0);
+#ifdef ZERO_ALLOCATION_TICKS
+  uint32_t zeroAllocationFromTick(UINT32_MAX);
+#endif
 
 
 
   entt::registry registry;
+  RegistryStats stats;
+  stats.connect(registry);
+  mobGroup(registry);  // Created before anything joins it
+  TimerWheel timerWheel;
+  AILodScheduler aiLod;
+  entt::dispatcher dispatcher;
+  GameplayEventHandler eventHandler;
+  FrameArena frameArena(FRAME_ARENA_SIZE);  // Scratch memory for one tick
+  RollbackRing rollback;  // The last few ticks, for resimulation
+  SpatialSorter spatialSorter;
+  SpriteBatch spriteBatch;  // Entity sprites for the frame being drawn
+  ViewCuller viewCuller(frameArena);
+  WorldSnapshot rollbackScratch;
 
   // Create player
   entt::entity playerEntity;
@@ -115,32 +545,37 @@ int main() {
     cc.position = {WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f};
     pc.hp = PLAYER_HEALTH;
   }
-  CharacterComponent& playerCc = registry.get<CharacterComponent>(playerEntity);
 
   // WEAPON
   entt::entity weaponEntity;
   weaponEntity = registry.create();
-  meleeWeaponComponent& wc =
-    registry.emplace<meleeWeaponComponent>(weaponEntity);
-  TimerComponent& weaponTc = registry.emplace<TimerComponent>(weaponEntity);
-  wc.hitboxRadius = 60.0f;
-  weaponTc.maxTime = SWORD_SWING_INTERVAL;
-  weaponTc.timeLeft = weaponTc.maxTime;
+  {
+    meleeWeaponComponent& wc =
+      registry.emplace<meleeWeaponComponent>(weaponEntity);
+    TimerComponent& weaponTc = registry.emplace<TimerComponent>(weaponEntity);
+    wc.hitboxRadius = 60.0f;
+    weaponTc.maxTime = SWORD_SWING_INTERVAL;
+    weaponTc.dueTick =
+      timerWheel.currentTick + secondsToTicks(weaponTc.maxTime);
+    timerWheel.schedule(weaponEntity, weaponTc.dueTick);
+  }
 
   entt::entity weaponAnimationEntity;
   weaponAnimationEntity = registry.create();
-  TimerComponent& animTimerTc =
-    registry.emplace<TimerComponent>(weaponAnimationEntity);
-  animTimerTc.maxTime = ATTACK_ANIMATION_LENGTH;
-  animTimerTc.timeLeft = animTimerTc.maxTime;
+  {
+    TimerComponent& animTimerTc =
+      registry.emplace<TimerComponent>(weaponAnimationEntity);
+    animTimerTc.maxTime = ATTACK_ANIMATION_LENGTH;
+  }
 
   bool canSwing = false;
 
   UniformGrid unigrid =
-    UniformGrid(WINDOW_HEIGHT, WINDOW_WIDTH, UNIGRID_CELL_SIZE);
+    UniformGrid(WINDOW_HEIGHT, WINDOW_WIDTH, UNIGRID_CELL_SIZE, frameArena);
 
   bool gameHasJustStarted(true);
   float startWaitTime(0.0f);
+  float timeSinceAutosave(0.0f);
 
   float accumulator(0.0f);
   float deltaTime(0.0f);
@@ -150,21 +585,32 @@ int main() {
   std::vector<entt::entity> entitiesToDelete;
 
 	InitAudioDevice();
+#ifdef BATCH_UPLOAD_MODE
+  // Override raylib's config.h, to compare upload paths on one build of raylib
+  rlSetBatchUploadMode(BATCH_UPLOAD_MODE);
+#endif
+#ifdef BATCH_VERTEX_FORMAT
+  rlSetBatchVertexFormat(BATCH_VERTEX_FORMAT);
+#endif
   InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_TITLE);
-  SetTargetFPS(TARGET_FPS);
+  SetTargetFPS(UNCAPPED_FPS ? 0 : TARGET_FPS);
 
   menuHandler.inGameGUI.hpBar.InitBar(PLAYER_HEALTH);
   health = PLAYER_HEALTH;
 
   // TEXTURES
-  Texture cursor = LoadTexture("./assets/cursorSword.png");
-  Texture playerTexture = LoadTexture("./assets/knight.png");
-  Texture playerAttackingTexture = LoadTexture("./assets/knightAttack.png");
-  Texture enemyRangedTexture = LoadTexture("./assets/enemyRanged.png");
-  Texture enemyMeleeTexture = LoadTexture("./assets/enemyMelee.png");
+  TextureAtlas atlas;  // Every sprite the game world and cursor draw
+  atlas.build();
+  spriteBatch.circleTexture = atlas.texture;
+  spriteBatch.circleSource = atlas.region(SPRITE_CIRCLE);
   Texture mainMenuBackground = LoadTexture("./assets/Hakenslash.png");
   Texture gameOverBackground = LoadTexture("./assets/GameOver.png");
   Texture floor = LoadTexture("./assets/Floor.png");
+  // Floor and HUD are drawn into textures when they change, not every frame
+  LayerCompositor layers;
+  layers.load(SCREEN_LAYER_FLOOR, {0, 0, WINDOW_WIDTH, WINDOW_HEIGHT});
+  layers.load(SCREEN_LAYER_HUD, {0, 0, WINDOW_WIDTH, 100});
+  layers.load(SCREEN_LAYER_FROZEN, {0, 0, WINDOW_WIDTH, WINDOW_HEIGHT});
 
 
   // MUSIC AND SOUND
@@ -173,13 +619,341 @@ int main() {
   Sound bloodSplatter = LoadSound("./assets/bloodSplatter.wav");
   tick = LoadSound("./assets/tick.wav");
 
+  eventHandler.score = &score;
+  eventHandler.menuHandler = &menuHandler;
+  eventHandler.bloodSplatter = bloodSplatter;
+  eventHandler.connect(dispatcher);
+
   PlayMusicStream(gameBgm);
   SetMusicVolume(gameBgm, 0.25);
 
+  // SAVING AND LOADING
+  auto saveGame = [&](const char* path) {
+    SnapshotHeader header;
+    header.rngState = gameRandom.state;
+    header.tick = timerWheel.currentTick;
+    header.score = score;
+    header.requiredEnemyCount = requiredEnemyCount;
+    header.timesEnemiesSpawned = timesEnemiesSpawned;
+    header.timesEnemiesSpedUp = timesEnemiesSpedUp;
+    header.startWaitTime = startWaitTime;
+    header.aiLodCurrentBucket = aiLod.currentBucket;
+    header.aiLodNextBucket = aiLod.nextBucket;
+    header.playerEntity = playerEntity;
+    header.weaponEntity = weaponEntity;
+    header.weaponAnimationEntity = weaponAnimationEntity;
+    header.gameHasJustStarted = gameHasJustStarted;
+    header.canSwing = canSwing;
+    header.isAttacking = isAttacking;
+    for (int i = 0; i < MOB_TYPE_COUNT; i++) {
+      header.mobsSpawned[i] = stats.spawned[i];
+      header.mobsDestroyed[i] = stats.destroyed[i];
+    }
+    if (!saveSnapshot(path, registry, header)) {
+      std::cout << "Could not save " << path << std::endl;
+    }
+  };
+
+  auto loadGame = [&](const char* path) {
+    inputRecorder.close();  // The recording can't follow a jump in time
+    SnapshotHeader header;
+    if (!loadSnapshot(path, registry, header)) {
+      std::cout << "Could not load " << path << std::endl;
+      return;
+    }
+    stats.connect(registry);
+    stats.recount(registry);
+    for (int i = 0; i < MOB_TYPE_COUNT; i++) {
+      stats.spawned[i] = header.mobsSpawned[i];
+      stats.destroyed[i] = header.mobsDestroyed[i];
+    }
+    gameRandom.state = header.rngState;
+    score = header.score;
+    requiredEnemyCount = header.requiredEnemyCount;
+    timesEnemiesSpawned = header.timesEnemiesSpawned;
+    timesEnemiesSpedUp = header.timesEnemiesSpedUp;
+    startWaitTime = header.startWaitTime;
+    aiLod.currentBucket = header.aiLodCurrentBucket;
+    aiLod.nextBucket = header.aiLodNextBucket;
+    playerEntity = header.playerEntity;
+    weaponEntity = header.weaponEntity;
+    weaponAnimationEntity = header.weaponAnimationEntity;
+    gameHasJustStarted = header.gameHasJustStarted;
+    canSwing = header.canSwing;
+    isAttacking = header.isAttacking;
+    rebuildTimerWheel(registry, timerWheel, header.tick);
+    unigrid.rebuild(registry);  // Drawn from before the first tick
+    rollback.clear();
+    dispatcher.clear();
+#ifdef ZERO_ALLOCATION_TICKS
+    zeroAllocationFromTick = UINT32_MAX;  // Warm up again on the next wave
+#endif
+    accumulator = 0.0f;
+
+    health = registry.get<PlayerComponent>(playerEntity).hp;
+    newScore = score;
+    layers.markDirty(SCREEN_LAYER_FROZEN);  // Loaded while already paused
+    menuHandler.setState(InPauseScreen);
+  };
+
+  // ROLLBACK
+  auto simulationState = [&]() -> SimulationState {
+    return {timerWheel.currentTick, gameRandom.state, aiLod.currentBucket,
+            aiLod.nextBucket, canSwing, isAttacking};
+  };
+
+  auto restoreWorld = [&](WorldSnapshot& snapshot) {
+    snapshot.restore(registry, timerWheel);
+    gameRandom.state = snapshot.state.rngState;
+    aiLod.currentBucket = snapshot.state.aiLodCurrentBucket;
+    aiLod.nextBucket = snapshot.state.aiLodNextBucket;
+    canSwing = snapshot.state.canSwing;
+    isAttacking = snapshot.state.isAttacking;
+  };
+
+  // One fixed physics step. Everything it needs from outside the simulation
+  // comes in through input, so rollback can replay it from a snapshot.
+  auto simulateTick = [&](const TickInput& input) {
+    AllocationScope allocationScope(ALLOC_SIMULATION);
+#ifdef ZERO_ALLOCATION_TICKS
+    NoAllocationScope noAllocation(
+      timerWheel.currentTick >= zeroAllocationFromTick
+    );
+#endif
+    TickContext context{
+      registry,   timerWheel, aiLod,         unigrid,
+      dispatcher, frameArena, spatialSorter, input,
+      playerEntity, weaponEntity, weaponAnimationEntity,
+      canSwing, isAttacking};
+    TickPipeline::run(context);
+  };
+
+  // Saved right before each tick, held to the same no-allocation rule as
+  // the tick itself
+  auto recordTick = [&](const TickInput& input) {
+    AllocationScope allocationScope(ALLOC_ROLLBACK);
+#ifdef ZERO_ALLOCATION_TICKS
+    NoAllocationScope noAllocation(
+      timerWheel.currentTick >= zeroAllocationFromTick
+    );
+#endif
+    rollback.record(registry, timerWheel, simulationState(), input);
+  };
+
+  // Time a full rollback: restore the state from ROLLBACK_MAX_TICKS ago,
+  // replay the recorded inputs back to now and check that the replay ends on
+  // the same state. Attacks and wave spawns happen between ticks and are not
+  // recorded, so a window containing one reports a mismatch.
+  auto benchmarkRollback = [&]() {
+    uint32_t now = timerWheel.currentTick;
+    uint32_t from = now - ROLLBACK_MAX_TICKS;
+    if (now < ROLLBACK_MAX_TICKS || !rollback.has(from)) {
+      std::cout << "Not enough ticks recorded to roll back" << std::endl;
+      return;
+    }
+    RegistryStats statsBefore = stats;
+    uint64_t expected = stateChecksum(registry, now);
+
+    double start = GetTime();
+    rollbackScratch.save(registry, timerWheel, simulationState());
+    double saved = GetTime();
+    restoreWorld(rollback.snapshotAt(from));
+    double restored = GetTime();
+    for (uint32_t t = from; t < now; t++) {
+      simulateTick(rollback.inputAt(t));
+    }
+    double resimulated = GetTime();
+    bool matches = stateChecksum(registry, now) == expected;
+
+    // Back to the present, without the replayed ticks' events
+    dispatcher.clear();
+    restoreWorld(rollbackScratch);
+    stats = statsBefore;
+
+    std::cout << TextFormat(
+                   "Rollback of %d ticks, %zu characters: save %.3f ms, "
+                   "restore %.3f ms, resimulate %.3f ms, %s",
+                   ROLLBACK_MAX_TICKS,
+                   registry.storage<CharacterComponent>().size(),
+                   (saved - start) * 1000.0, (restored - saved) * 1000.0,
+                   (resimulated - restored) * 1000.0,
+                   matches ? "state matches" : "state differs"
+                 )
+              << std::endl;
+  };
+
+#ifdef ZERO_ALLOCATION_TICKS
+  // Record and run ZERO_ALLOCATION_CHECK_TICKS ticks from the current state
+  // with the current input, all of them under NoAllocationScope, count the
+  // heap allocations they made and go back to where the check started. Long
+  // enough for every timer to fire and be rescheduled many times over.
+  auto checkZeroAllocationTicks = [&](const TickInput& input) {
+    if (timerWheel.currentTick < zeroAllocationFromTick) {
+      std::cout << "Ticks may still allocate, wait for the warm-up to end"
+                << std::endl;
+      return;
+    }
+    RegistryStats statsBefore = stats;
+    size_t forbiddenBefore = allocationTracker.forbiddenAllocations;
+    rollbackScratch.save(registry, timerWheel, simulationState());
+
+    for (int t = 0; t < ZERO_ALLOCATION_CHECK_TICKS; t++) {
+      recordTick(input);
+      simulateTick(input);
+      dispatcher.clear();  // Keeps the event queues at one tick's worth
+    }
+    size_t allocations =
+      allocationTracker.forbiddenAllocations - forbiddenBefore;
+
+    restoreWorld(rollbackScratch);
+    stats = statsBefore;
+    rollback.clear();  // Holds the checked ticks, not the real ones
+
+    std::cout << TextFormat(
+                   "%d ticks, %zu characters: %zu heap allocations",
+                   ZERO_ALLOCATION_CHECK_TICKS,
+                   registry.storage<CharacterComponent>().size(), allocations
+                 )
+              << std::endl;
+  };
+#endif
+
+  // Floor, entities and score, as the game shows them and a paused game
+  // keeps them
+  auto drawWorld = [&]() {
+    layers.draw(SCREEN_LAYER_FLOOR);
+    // Uniform Grid
+    // unigrid.draw();
+
+    // Entities
+    // Fetched again, this frame's ticks may have reordered the storages
+    Vector2 playerPosition =
+      registry.get<CharacterComponent>(playerEntity).position;
+    // Only what the grid has under the view, queued and drawn grouped by
+    // texture once everything is in
+    viewCuller.collect(
+      registry, unigrid, {0.0f, 0.0f, WINDOW_WIDTH, WINDOW_HEIGHT}
+    );
+    for (entt::entity e : viewCuller.visible) {
+      const CharacterComponent& cc = registry.get<CharacterComponent>(e);
+      switch (registry.get<MobComponent>(e).type) {
+        case MELEE:
+          spriteBatch.draw(
+            LAYER_MOBS, atlas.texture, atlas.region(SPRITE_MELEE),
+            {cc.position.x, cc.position.y, 96.75, 63}, {48.375, 31.5},
+            facingVector(playerPosition, cc.position),
+            WHITE
+          );
+          break;
+        case RANGE:
+          spriteBatch.draw(
+            LAYER_MOBS, atlas.texture, atlas.region(SPRITE_RANGED),
+            {cc.position.x, cc.position.y, 100.8, 96.48}, {50.4, 48.24},
+            facingVector(playerPosition, cc.position),
+            WHITE
+          );
+          break;
+        case BULLET:
+          spriteBatch.drawCircle(
+            LAYER_BULLETS, cc.position, cc.hitboxRadius, YELLOW
+          );
+          break;
+        case FRIENDLY_BULLET:
+          spriteBatch.drawCircle(
+            LAYER_BULLETS, cc.position, cc.hitboxRadius, BLUE
+          );
+          break;
+        default:
+          break;
+      }
+    }
+
+    // Player, drawn over the mobs
+    spriteBatch.draw(
+      LAYER_PLAYER, atlas.texture,
+      atlas.region(isAttacking ? SPRITE_PLAYER_ATTACKING : SPRITE_PLAYER),
+      {playerPosition.x, playerPosition.y, 134, 106},
+      {67 / 2, 50},
+      facingVector(playerPosition, GetMousePosition()),
+      WHITE
+    );
+    spriteBatch.flush();
+
+    // Weapon Hitbox Visual
+    //auto weap = registry.view<meleeWeaponComponent>();
+    //for (auto e : weap) {
+      //meleeWeaponComponent* wc = registry.try_get<meleeWeaponComponent>(e);
+      //DrawCircleV(wc->position, wc->hitboxRadius, GREEN);
+    //}
+
+
+    // score
+    DrawText(TextFormat("%d", score), 10, 10, 20, PURPLE);
+  };
+
+  if (replaying) {
+    menuHandler.setState(InGame);
+  }
+
+  int targetFps(TARGET_FPS);
   while (!WindowShouldClose()) {
     deltaTime = GetFrameTime();
+#ifdef DETERMINISTIC_MATH
+    // Exactly one tick per frame, so the ticks only depend on the frame count
+    // and not on how long frames took
+    deltaTime = TIMESTEP;
+#endif
     HideCursor();
     state = menuHandler.getState();
+    if (replaying && (inputReplay.done() || state != InGame)) {
+      break;
+    }
+    if ((state == InGame ? TARGET_FPS : MENU_FPS) != targetFps) {
+      targetFps = state == InGame ? TARGET_FPS : MENU_FPS;
+      SetTargetFPS(UNCAPPED_FPS ? 0 : targetFps);
+      // The first frame back in game measured a frame spent in a menu, none
+      // of which should be simulated
+      if (state == InGame) deltaTime = TIMESTEP;
+    }
+
+    if (IsKeyPressed(DEBUG_OVERLAY_KEY)) {
+      showDebugOverlay = !showDebugOverlay;
+    }
+    if (IsKeyPressed(ALLOCATION_LOG_KEY)) {
+      if (allocationLog.is_open()) {
+        allocationLog.close();
+      } else {
+        allocationLog.open(ALLOCATION_LOG_PATH, std::ofstream::trunc);
+        allocationLog << "frame,bytes";
+        for (int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+          allocationLog << "," << ALLOC_SUBSYSTEM_NAMES[i];
+        }
+        allocationLog << "\n";
+        loggedFrames = 0;
+      }
+    }
+
+    if (state == InGame || state == InPauseScreen) {
+      if (IsKeyPressed(QUICK_SAVE_KEY)) {
+        saveGame(QUICK_SAVE_PATH);
+      }
+    }
+    // A replay only follows the recorded inputs, keys that change the world
+    // or reorder its storages are ignored until it ends
+    if (IsKeyPressed(QUICK_LOAD_KEY) && !replaying) {
+      loadGame(QUICK_SAVE_PATH);
+    } else if (IsKeyPressed(AUTOSAVE_LOAD_KEY) && !replaying) {
+      loadGame(AUTOSAVE_PATH);
+    }
+    state = menuHandler.getState();
+
+    // Fetched every frame, loading a snapshot rebuilds the storages
+    CharacterComponent& playerCc =
+      registry.get<CharacterComponent>(playerEntity);
+    meleeWeaponComponent& wc = registry.get<meleeWeaponComponent>(weaponEntity);
+    TimerComponent& weaponTc = registry.get<TimerComponent>(weaponEntity);
+    TimerComponent& animTimerTc =
+      registry.get<TimerComponent>(weaponAnimationEntity);
     
 
     
@@ -187,6 +961,20 @@ int main() {
     
 
     if (state == InGame) {
+#ifdef DETERMINISTIC_MATH
+      if (!recordedRun) {
+        inputRecorder.open(INPUT_LOG_PATH, DETERMINISTIC_SEED);
+        recordedRun = true;
+      }
+#endif
+
+      // Autosave for crash recovery
+      timeSinceAutosave += deltaTime;
+      if (timeSinceAutosave >= AUTOSAVE_INTERVAL) {
+        saveGame(AUTOSAVE_PATH);
+        timeSinceAutosave = 0.0f;
+      }
+
       if (gameHasJustStarted) {
         // Wait a bit before spawning enemies
         if (startWaitTime < WAIT_TIME_BEFORE_FIRST_SPAWN) {
@@ -211,20 +999,23 @@ int main() {
       }
       playerMoveDirection = Vector2Normalize(playerMoveDirection);
 
-      if (IsKeyPressed(PAUSE_KEY)) {
+      FrameInput frameInput = {
+        playerMoveDirection, GetMousePosition(),
+        IsMouseButtonPressed(MOUSE_BUTTON_LEFT)};
+      if (replaying) {
+        frameInput = inputReplay.advance();
+      } else if (inputRecorder.recording()) {
+        inputRecorder.record(frameInput);
+      }
+
+      if (IsKeyPressed(PAUSE_KEY) && !replaying) {
         menuHandler.setState(InPauseScreen);
       }
 
       // Enemy Spawning
       // Spawn when enemies are a quarter of requiredEnemyCount
       if (!gameHasJustStarted) {
-        int currentEnemyCount = 0;
-        for (auto e : registry.view<MobComponent>()) {
-          MobComponent& mc = registry.get<MobComponent>(e);
-          if (mc.type == MELEE || mc.type == RANGE) {
-            currentEnemyCount++;
-          }
-        }
+        int currentEnemyCount = stats.liveEnemies();
         if (currentEnemyCount <= ceil(requiredEnemyCount / 4.0f)) {
 					timesEnemiesSpawned++;
 
@@ -232,233 +1023,151 @@ int main() {
 						timesEnemiesSpedUp++;
 					}
 
-          spawnEnemies(registry, currentEnemyCount + requiredEnemyCount, timesEnemiesSpedUp + 1);
+          AllocationScope allocationScope(ALLOC_SPAWNING);
+          spawnEnemies(registry, frameArena, timerWheel, aiLod, currentEnemyCount + requiredEnemyCount, timesEnemiesSpedUp + 1);
           requiredEnemyCount += ADDITIONAL_ENEMY_COUNT;
 
+          // Make room for the next wave now rather than when it spawns, and
+          // for everything the ticks fill up until then
+          reserveForWave(
+            registry, ceil(requiredEnemyCount / 4.0f) + requiredEnemyCount
+          );
+          unigrid.reserveCells(
+            registry.storage<CharacterComponent>().capacity(),
+            MOB_HITBOX_RADIUS
+          );
+          spatialSorter.reserve(registry.capacity());
+          // Live timers plus the stale ones of mobs killed before they fired
+          size_t timers = 2 * registry.capacity();
+          timerWheel.reserve(timers);
+          rollback.reserve(registry.capacity(), timers);
+          spriteBatch.reserve(
+            registry.storage<CharacterComponent>().capacity()
+          );
+          viewCuller.reserve(registry.capacity());
+          eventHandler.reserve(
+            dispatcher, registry.storage<MobComponent>().capacity()
+          );
+#ifdef ZERO_ALLOCATION_TICKS
+          if (zeroAllocationFromTick == UINT32_MAX) {
+            zeroAllocationFromTick =
+              timerWheel.currentTick + ZERO_ALLOCATION_WARMUP_TICKS;
+          }
+#endif
         }
       }
 
       // Attack
-      if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+      if (frameInput.attack) {
         if (canSwing) {
           isAttacking = true;
+          animTimerTc.dueTick =
+            timerWheel.currentTick + secondsToTicks(animTimerTc.maxTime);
+          timerWheel.schedule(weaponAnimationEntity, animTimerTc.dueTick);
           PlaySound(swordSwing);
           // Attack collision
-          for (auto e : registry.view<CharacterComponent>()) {
-            CharacterComponent& cc = registry.get<CharacterComponent>(e);
-
-            MobComponent* mc = registry.try_get<MobComponent>(e);
-            if (mc) {
-              if (checkWeaponCollision(wc, cc)) {
-                ScoreOnKillComponent* sokc =
-                  registry.try_get<ScoreOnKillComponent>(e);
-                if (sokc) {
-                  score += sokc->score;
-                }
-                if (mc->type == MELEE || mc->type == RANGE) {
-                  PlaySoundMulti(bloodSplatter);
-                  registry.destroy(e);
-                } else {
-                  StraightMovementComponent* smc =
-                    registry.try_get<StraightMovementComponent>(e);
-                  if (smc) {
-                    // Deflect bullets
-                    mc->type = FRIENDLY_BULLET;
-                    cc.velocity = Vector2Scale(
-                      cc.velocity, FRIENDLY_BULLET_SPEED_MULTIPLIER
-                    );
-                    // Get the average angle between player rotation and smc
-                    // direction
-                    float playerRotation =
-                      findRotationAngle(playerCc.position, GetMousePosition());
-                    float bulletAngle =
-                      atan2f(-smc->direction.y, -smc->direction.x);
-                    float newBulletAngle = (playerRotation + bulletAngle) / 2;
-                    smc->direction = {cos(newBulletAngle), sin(newBulletAngle)};
-                  }
+          // Fetched here, destroying mobs can move the player's component
+          float playerRotation = findRotationAngle(
+            registry.get<CharacterComponent>(playerEntity).position,
+            frameInput.aimPosition
+          );
+          for (auto [e, cc, mc] : mobGroup(registry).each()) {
+            if (checkWeaponCollision(wc, cc)) {
+              ScoreOnKillComponent* sokc =
+                registry.try_get<ScoreOnKillComponent>(e);
+              if (mc.type == MELEE || mc.type == RANGE) {
+                dispatcher.enqueue<KillEvent>(sokc ? sokc->score : 0);
+                registry.destroy(e);
+              } else {
+                StraightMovementComponent* smc =
+                  registry.try_get<StraightMovementComponent>(e);
+                if (smc) {
+                  // Deflect bullets
+                  stats.retype(mc, FRIENDLY_BULLET);
+                  cc.velocity = Vector2Scale(
+                    cc.velocity, FRIENDLY_BULLET_SPEED_MULTIPLIER
+                  );
+                  // Get the average angle between player rotation and smc
+                  // direction
+                  float bulletAngle =
+                    simAtan2(-smc->direction.y, -smc->direction.x);
+                  float newBulletAngle = (playerRotation + bulletAngle) / 2;
+                  smc->direction = {
+                    simCos(newBulletAngle), simSin(newBulletAngle)};
+                  dispatcher.enqueue<DeflectEvent>(cc.position, smc->direction);
                 }
               }
             }
-            canSwing = false;
-            weaponTc.timeLeft = weaponTc.maxTime;
           }
+          canSwing = false;
+          weaponTc.dueTick =
+            timerWheel.currentTick + secondsToTicks(weaponTc.maxTime);
+          timerWheel.schedule(weaponEntity, weaponTc.dueTick);
         }
       }
 
       // Physics Process
       accumulator += deltaTime;
       while (accumulator >= TIMESTEP) {
-        
-      	unigrid.clearCells();
-        // Move player character
-        playerCc.position = Vector2Add(
-          playerCc.position,
-          Vector2Scale(playerMoveDirection, PLAYER_MOVESPEED * TIMESTEP)
-        );
-				playerCc.position = clampToRectangle(playerCc.position, {20.0f, 120.0f, WINDOW_WIDTH - 20.0f, WINDOW_HEIGHT - 20.0f});
-
-        // Weapon Hitbox Tracking and Swing Cooldown
-        wc.position = Vector2Add(
-          playerCc.position, Vector2Scale(
-                               Vector2Normalize(Vector2Subtract(
-                                 GetMousePosition(), playerCc.position
-                               )),
-                               SWORD_REACH
-                             )
-        );
-        if (weaponTc.timeLeft <= 0.0f) {
-          canSwing = true;
-        } else {
-          weaponTc.timeLeft -= TIMESTEP;
-        }
-
-        // Weapon Animation
-        if (isAttacking) {
-          animTimerTc.timeLeft -= TIMESTEP;
-          if (animTimerTc.timeLeft <= 0) {
-            isAttacking = false;
-            animTimerTc.timeLeft = animTimerTc.maxTime;
-          }
-        }
-
-        for (auto e : registry.view<CharacterComponent>()) {
-          CharacterComponent& cc = registry.get<CharacterComponent>(e);
-
-          TimerComponent* tc = registry.try_get<TimerComponent>(e);
-          StraightMovementComponent* smc =
-            registry.try_get<StraightMovementComponent>(e);
-          MobComponent* mc = registry.try_get<MobComponent>(e);
-
-          // Check if range enemy should shoot
-          if (tc) {
-            tc->timeLeft -= TIMESTEP;
-            if (tc->timeLeft <= 0.0f) {
-              // Create and shoot bullet
-              entt::entity e = registry.create();
-              CharacterComponent& bulletCc =
-                registry.emplace<CharacterComponent>(e);
-              MobComponent& mc = registry.emplace<MobComponent>(e);
-              StraightMovementComponent& smc =
-                registry.emplace<StraightMovementComponent>(e);
-              mc.type = BULLET;
-              mc.spawnPosition = cc.position;
-              bulletCc.hitboxRadius = 5.0f;
-              bulletCc.position = cc.position;
-              bulletCc.velocity = {BULLET_SPEED, BULLET_SPEED};
-              smc.direction =
-                Vector2Normalize(Vector2Subtract(playerCc.position, cc.position)
-                );
-
-              tc->timeLeft = tc->maxTime;
-            }
-          }
-
-          if (smc) {
-            moveDirectional(cc, smc->direction, TIMESTEP);
-            // Destroy SMC if it's not visible anymore
-            if (!isWithinRectangle(
-                  cc.position, {0.0f, 0.0f, WINDOW_WIDTH, WINDOW_HEIGHT}
-                )) {
-              registry.destroy(e);
-            }
-          }
-
-          // Move mobs
-          if (mc) {
-            switch (mc->type) {
-              case MELEE:
-                moveTowards(cc, playerCc.position, TIMESTEP);
-                break;
-              case RANGE:
-                moveTowardsWithSlowOnLimit(
-                  cc, playerCc.position, ENEMY_RANGE_SAFE_DISTANCE, TIMESTEP
-                );
-                break;
-              default:
-                break;
-            }
-
-            // Destroy character if it collides with player
-            if (charactersAreColliding(playerCc, cc)) {
-              PlayerComponent& pc = registry.get<PlayerComponent>(playerEntity);
-              registry.destroy(e);
-              PlaySoundMulti(bloodSplatter);
-              pc.hp -= 1;
-              health = pc.hp;
-              std::cout << health << std::endl;
-              // GAME OVER?
-              if (pc.hp <= 0) {
-                menuHandler.gameOverScreen.scoreLabel.text =
-                  "SCORE: " + std::to_string(score);
-                memset(
-                  menuHandler.gameOverScreen.playerName.text, '\0',
-                  sizeof(menuHandler.gameOverScreen.playerName.text)
-                );
-                menuHandler.gameOverScreen.playerName.letterCount = 0;
-                newScore = score;
-                menuHandler.setState(InGameOverScreen);
-              }
-            }
-          }
+        TickInput input = {frameInput.moveDirection, frameInput.aimPosition};
+        recordTick(input);
+        simulateTick(input);
+#ifdef DETERMINISTIC_MATH
+        // One line per tick, diff the logs of two builds to compare them
+        checksumLog << timerWheel.currentTick << " "
+                    << stateChecksum(registry, timerWheel.currentTick) << "\n";
+#endif
+        accumulator -= TIMESTEP;
+      }
 
-          // Mob collisions
-          // Check collision with other mobs
-          for (size_t i = 0; i < unigrid.cells.size(); i++) {
-            for (size_t j = 0; j < unigrid.cells[i].size(); j++) {
-							if (unigrid.cells[i][j].objects.empty()) continue;
-              for (size_t obj1 = 0; obj1 < unigrid.cells[i][j].objects.size();
-                   obj1++) {
-                for (size_t obj2 = 0; obj2 < unigrid.cells[i][j].objects.size();
-                     obj2++) {
-                  if (obj1 == obj2) continue;
-
-                  entt::entity eA = unigrid.cells[i][j].objects[obj1];
-                  entt::entity eB = unigrid.cells[i][j].objects[obj2];
-
-                  if (!registry.valid(eA) || !registry.valid(eB)) continue;
-
-                  // Don't collide with player
-                  if (registry.try_get<PlayerComponent>(eA) || registry.try_get<PlayerComponent>(eB))
-                    continue;
-
-                  MobComponent* aMc = registry.try_get<MobComponent>(eA);
-                  MobComponent* bMc = registry.try_get<MobComponent>(eB);
-
-                  // Don't collide with bullets
-                  if (aMc->type == BULLET || bMc->type == BULLET) continue;
-
-                  CharacterComponent* aCc =
-                    registry.try_get<CharacterComponent>(eA);
-                  CharacterComponent* bCc =
-                    registry.try_get<CharacterComponent>(eB);
-
-                  if (charactersAreColliding(*aCc, *bCc)) {
-                    ScoreOnKillComponent* aSokc =
-                      registry.try_get<ScoreOnKillComponent>(eA);
-                    // Collide with friendly bullets
-                    if (bMc->type == FRIENDLY_BULLET) {
-                      if (aSokc) {
-                        score += aSokc->score;
-                      }
-                      registry.destroy(eA);
-                      PlaySoundMulti(bloodSplatter);
-                    } else {
-                      separateCharacters(*aCc, *bCc);
-                    }
-                  }
-                }
-              }
-            }
-          }
+      // Scoring, audio and UI for everything that happened this frame
+      {
+        AllocationScope allocationScope(ALLOC_EVENTS);
+        eventHandler.dispatch(dispatcher);
+      }
 
-          refreshUnigridPositions(&cc, UNIGRID_CELL_SIZE);
-          unigrid.refreshPosition(registry, e);
-        }
-        accumulator -= TIMESTEP;
+      if (IsKeyPressed(ROLLBACK_BENCHMARK_KEY) && !replaying) {
+        inputRecorder.close();  // Restoring can reorder the storages
+        benchmarkRollback();
+      }
+#ifdef ZERO_ALLOCATION_TICKS
+      if (IsKeyPressed(ZERO_ALLOCATION_CHECK_KEY) && !replaying) {
+        inputRecorder.close();  // Restoring can reorder the storages
+        checkZeroAllocationTicks(
+          {frameInput.moveDirection, frameInput.aimPosition}
+        );
+      }
+#endif
+      if (IsKeyPressed(GROUP_BENCHMARK_KEY) && !replaying) {
+        rollbackScratch.save(registry, timerWheel, simulationState());
+        GroupBenchResult result = benchmarkGroups(rollbackScratch);
+        std::cout << TextFormat(
+                       "Iterating %zu mobs: view with lookups %.4f ms, "
+                       "view %.4f ms, non-owning group %.4f ms, "
+                       "owning group %.4f ms",
+                       result.mobs, result.viewWithLookups, result.view,
+                       result.nonOwningGroup, result.owningGroup
+                     )
+                  << std::endl;
+      }
+      if (IsKeyPressed(LAYOUT_BENCHMARK_KEY) && !replaying) {
+        rollbackScratch.save(registry, timerWheel, simulationState());
+        LayoutBenchResult result = benchmarkLayouts(rollbackScratch);
+        std::cout << TextFormat(
+                       "Moving and gridding %zu mobs: unsplit components "
+                       "%.1f KiB %.4f ms, split components %.1f KiB %.4f ms",
+                       result.mobs, result.unsplitBytes / 1024.0f,
+                       result.unsplit, result.splitBytes / 1024.0f,
+                       result.split
+                     )
+                  << std::endl;
       }
     }
 
     else {
+      if (state != InPauseScreen) {
+        inputRecorder.close();  // Only one run is recorded
+      }
       if (state == InMainMenu) {  // Reset the game
         PlayerComponent& pc = registry.get<PlayerComponent>(playerEntity);
         menuHandler.inGameGUI.hpBar.InitBar(PLAYER_HEALTH);
@@ -474,6 +1183,10 @@ int main() {
         for (auto mob : registry.view<MobComponent>()) {
           registry.destroy(mob);
         }
+        rollback.clear();
+#ifdef ZERO_ALLOCATION_TICKS
+        zeroAllocationFromTick = UINT32_MAX;
+#endif
       } else if (state == InPauseScreen) {
         if (IsKeyPressed(PAUSE_KEY)) {
           menuHandler.setState(InGame);
@@ -481,120 +1194,102 @@ int main() {
       }
     }
 
-    menuHandler.Update();
+    {
+      AllocationScope allocationScope(ALLOC_UI);
+      menuHandler.Update();
+    }
     UpdateMusicStream(gameBgm);
 
-    BeginDrawing();
-    ClearBackground(WHITE);
-
-    if (state == InGame || state == InPauseScreen) {
-      DrawTexture(floor, 0, 0, WHITE);
-      // Uniform Grid
-      // unigrid.draw();
-
-      // Entities
-      for (auto e : registry.view<CharacterComponent>()) {
-        CharacterComponent& cc = registry.get<CharacterComponent>(e);
-        Color color;
-        MobComponent* mc = registry.try_get<MobComponent>(e);
-        PlayerComponent* pc = registry.try_get<PlayerComponent>(e);
-        if (mc) {
-          switch (mc->type) {
-            Rectangle enemyRec;
-            Rectangle enemyWindowRec;
-
-            case MELEE:
-              color = RED;
-              enemyRec.x = 56;
-              enemyRec.y = 120;
-              enemyRec.width = 430;
-              enemyRec.height = 280;
-              enemyWindowRec.x = cc.position.x;
-              enemyWindowRec.y = cc.position.y;
-              enemyWindowRec.width = 96.75;
-              enemyWindowRec.height = 63;
-              DrawTexturePro(enemyMeleeTexture, enemyRec, enemyWindowRec, {48.375, 31.5}, findRotationAngle(playerCc.position, cc.position) * RAD2DEG, WHITE);
-              break;
-            case RANGE:
-              color = YELLOW;
-              enemyRec.x = 108;
-              enemyRec.y = 128;
-              enemyRec.width = 280;
-              enemyRec.height = 267;
-              enemyWindowRec.x = cc.position.x;
-              enemyWindowRec.y = cc.position.y;
-              enemyWindowRec.width = 100.8;
-              enemyWindowRec.height = 96.48;
-              DrawTexturePro(enemyRangedTexture, enemyRec, enemyWindowRec, {50.4, 48.24}, findRotationAngle(playerCc.position, cc.position) * RAD2DEG, WHITE);
-              break;
-            case BULLET:
-              color = YELLOW;
-              break;
-            case FRIENDLY_BULLET:
-              color = BLUE;
-              break;
-            default:
-              color = BLACK;
-          }
-          if (mc->type == BULLET || mc ->type == FRIENDLY_BULLET){
-            DrawCircleV(cc.position, cc.hitboxRadius, color);
-          }
-          
-        }
-        if (pc) {
-          Rectangle playerRec;  // Texture coords
-          Rectangle windowRec;  //
-          playerRec.x = 0;
-          playerRec.y = 0;
-          playerRec.width = 200;
-          playerRec.height = 106;
-          windowRec.x = cc.position.x;
-          windowRec.y = cc.position.y;
-          windowRec.width = 134;
-          windowRec.height = 106;
-
-          
-          if (isAttacking == false) {
-            DrawTexturePro(
-              playerTexture, playerRec, windowRec, {67 / 2, 50},
-              findRotationAngle(cc.position, GetMousePosition()) * RAD2DEG,
-              WHITE
-            );
-          } else {
-            DrawTexturePro(
-              playerAttackingTexture, playerRec, windowRec, {67 / 2, 50},
-              findRotationAngle(cc.position, GetMousePosition()) * RAD2DEG,
-              WHITE
-            );
-          }
-        }
+    {
+      AllocationScope allocationScope(ALLOC_RENDERING);
+      if (menuHandler.inGameGUI.dirty) {
+        layers.markDirty(SCREEN_LAYER_HUD);
+        menuHandler.inGameGUI.dirty = false;
+      }
+      layers.update(SCREEN_LAYER_FLOOR, [&]() {
+        DrawTexture(floor, 0, 0, WHITE);
+      });
+      layers.update(SCREEN_LAYER_HUD, [&]() {
+        menuHandler.inGameGUI.Draw();
+      });
+      // Nothing moves while paused, the world is drawn once on the first
+      // paused frame and shown from the texture after that
+      if (state == InPauseScreen) {
+        layers.update(SCREEN_LAYER_FROZEN, drawWorld);
+      } else {
+        layers.markDirty(SCREEN_LAYER_FROZEN);
       }
 
-      // Weapon Hitbox Visual
-      //auto weap = registry.view<meleeWeaponComponent>();
-      //for (auto e : weap) {
-        //meleeWeaponComponent* wc = registry.try_get<meleeWeaponComponent>(e);
-        //DrawCircleV(wc->position, wc->hitboxRadius, GREEN);
-      //}
+      BeginDrawing();
+      if (IsKeyPressed(BULLET_BENCHMARK_KEY) && !replaying) {
+        BulletBenchResult result =
+          benchmarkBulletRendering(spriteBatch, WINDOW_WIDTH, WINDOW_HEIGHT);
+        std::cout << TextFormat(
+                       "Drawing %d bullets: circles %zu vertices %.3f ms, "
+                       "atlas quads %zu vertices %.3f ms",
+                       result.bullets, result.fanVertices, result.fanMs,
+                       result.quadVertices, result.quadMs
+                     )
+                  << std::endl;
+      }
+      ClearBackground(WHITE);
 
+      if (state == InGame) {
+        drawWorld();
+        newScore = score;
+      } else if (state == InPauseScreen) {
+        layers.draw(SCREEN_LAYER_FROZEN);
+      }
+      if (state == InGame || state == InPauseScreen) {
+        if (showDebugOverlay) {
+          drawDebugOverlay(
+            registry, stats, frameArena, spatialSorter, spriteBatch,
+            viewCuller, batchFlushMs, endDrawingMs, layers, WINDOW_HEIGHT
+          );
+        }
+      }
+    
+      menuHandler.menuList[InMainMenu]->loadBackgroundTexture(mainMenuBackground);
+      menuHandler.menuList[InGameOverScreen]->loadBackgroundTexture(gameOverBackground);
+      if (menuHandler.getState() == InGame) {
+        layers.draw(SCREEN_LAYER_HUD);
+      } else {
+        menuHandler.Draw();
+      }
+      Vector2 mouse = GetMousePosition();
+      const Rectangle& cursorRegion = atlas.region(SPRITE_CURSOR);
+      DrawTexturePro(
+        atlas.texture, cursorRegion,
+        {mouse.x, mouse.y, cursorRegion.width * 0.25f,
+         cursorRegion.height * 0.25f},
+        {0, 0}, 0, WHITE
+      );
+      // Flushed here rather than in EndDrawing, so the vertex upload and draw
+      // submission time on their own. A wait on the GPU can also land in
+      // the buffer swap, so the whole of EndDrawing is timed as well.
+      double flushStart = GetTime();
+      rlDrawRenderBatchActive();
+      double flushEnd = GetTime();
+      EndDrawing();
+      batchFlushMs += ((flushEnd - flushStart) * 1000.0 - batchFlushMs) * 0.05;
+      endDrawingMs +=
+        ((GetTime() - flushStart) * 1000.0 - endDrawingMs) * 0.05;
+      layers.endFrame(GetTime());
+    }
 
-      // score
-      DrawText(std::to_string(score).c_str(), 10, 10, 20, PURPLE);
-      newScore = score;
+    allocationTracker.endFrame();
+    if (allocationLog.is_open()) {
+      allocationLog << loggedFrames++ << ","
+                    << allocationTracker.lastFrameTotal().bytes;
+      for (int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+        allocationLog << "," << allocationTracker.lastFrame[i].allocations;
+      }
+      allocationLog << "\n";
     }
-    
-    menuHandler.menuList[InMainMenu]->loadBackgroundTexture(mainMenuBackground);
-    menuHandler.menuList[InGameOverScreen]->loadBackgroundTexture(gameOverBackground);
-    menuHandler.Draw();
-    DrawTextureEx(cursor, GetMousePosition(), 0, 0.25, WHITE);
-    EndDrawing();
   }
   
-  UnloadTexture(cursor);  
-	UnloadTexture(playerTexture);
-	UnloadTexture(playerAttackingTexture);
-  UnloadTexture(enemyRangedTexture);
-  UnloadTexture(enemyMeleeTexture);
+  atlas.unload();
+  layers.unload();
   UnloadTexture(mainMenuBackground);
   UnloadTexture(floor);
   UnloadSound(tick);
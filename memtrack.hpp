@@ -0,0 +1,179 @@
+#ifndef MEM_TRACK
+#define MEM_TRACK
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+#include "entt.hpp"
+
+// Memory resource that counts what goes through it before passing the
+// request on to its upstream resource (the global heap by default)
+struct CountingResource : public std::pmr::memory_resource {
+  const char* name;
+  std::pmr::memory_resource* upstream = std::pmr::new_delete_resource();
+
+  size_t bytes = 0;  // Currently allocated
+  size_t peakBytes = 0;
+  size_t allocations = 0;  // Currently live
+  size_t totalAllocations = 0;
+
+  CountingResource* nextResource;  // Every resource, in creation order
+
+  CountingResource(const char* _name) : name(_name) {
+    CountingResource** last = &firstResource();
+    while (*last) last = &(*last)->nextResource;
+    *last = this;
+    nextResource = nullptr;
+  }
+
+  static CountingResource*& firstResource() {
+    static CountingResource* first = nullptr;
+    return first;
+  }
+
+  void* do_allocate(const size_t size, const size_t alignment) override {
+    void* p = upstream->allocate(size, alignment);
+    bytes += size;
+    if (bytes > peakBytes) peakBytes = bytes;
+    allocations++;
+    totalAllocations++;
+    return p;
+  }
+
+  void do_deallocate(void* p, const size_t size, const size_t alignment)
+    override {
+    upstream->deallocate(p, size, alignment);
+    bytes -= size;
+    allocations--;
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    override {
+    return this == &other;
+  }
+};
+
+// Keeps scratch registries, such as the benchmarks' copies of the world,
+// out of the game's peaks and totals. Everything they allocate must be freed
+// before the scope ends.
+struct ScratchMemoryScope {
+  struct Counts {
+    size_t peakBytes;
+    size_t totalAllocations;
+  };
+  std::vector<Counts> saved;
+
+  ScratchMemoryScope() {
+    for (CountingResource* r = CountingResource::firstResource(); r;
+         r = r->nextResource) {
+      saved.push_back({r->peakBytes, r->totalAllocations});
+    }
+  }
+
+  ~ScratchMemoryScope() {
+    size_t i = 0;
+    for (CountingResource* r = CountingResource::firstResource();
+         r && i < saved.size(); r = r->nextResource, i++) {
+      r->peakBytes = saved[i].peakBytes;
+      r->totalAllocations = saved[i].totalAllocations;
+    }
+  }
+};
+
+// One counting resource per tracked component type
+template <typename Tag>
+struct ComponentMemory {
+  static CountingResource& resource();
+};
+
+// Allocator for the memory that belongs to the Tag component: the pages of
+// its entt storage and any containers inside the component itself.
+// entt requires a storage's entity index to share the registry's allocator
+// type, so rebinding to entities goes back to std::allocator and those
+// arrays are accounted for separately by the stats.
+template <typename T, typename Tag>
+struct ComponentAllocator {
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = std::conditional_t<
+      std::is_same_v<U, entt::entity>, std::allocator<U>,
+      ComponentAllocator<U, Tag>>;
+  };
+
+  ComponentAllocator() noexcept {}
+
+  // The registry builds storages from its own std::allocator
+  template <typename U>
+  ComponentAllocator(const std::allocator<U>&) noexcept {}
+
+  template <typename U>
+  ComponentAllocator(const ComponentAllocator<U, Tag>&) noexcept {}
+
+  template <typename U>
+  operator std::allocator<U>() const noexcept {
+    return std::allocator<U>();
+  }
+
+  T* allocate(const size_t n) {
+    return static_cast<T*>(
+      ComponentMemory<Tag>::resource().allocate(n * sizeof(T), alignof(T))
+    );
+  }
+
+  void deallocate(T* p, const size_t n) {
+    ComponentMemory<Tag>::resource().deallocate(p, n * sizeof(T), alignof(T));
+  }
+
+  template <typename U>
+  bool operator==(const ComponentAllocator<U, Tag>&) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const ComponentAllocator<U, Tag>&) const noexcept {
+    return false;
+  }
+};
+
+struct ComponentMemoryStats {
+  const char* name;
+  size_t bytes;
+  size_t peakBytes;
+  size_t allocations;
+  size_t totalAllocations;
+  size_t indexBytes;  // Packed entity array, allocated outside the resource
+};
+
+template <typename Type>
+static ComponentMemoryStats componentMemoryStats(entt::registry& registry) {
+  CountingResource& resource = ComponentMemory<Type>::resource();
+  return {
+    resource.name,
+    resource.bytes,
+    resource.peakBytes,
+    resource.allocations,
+    resource.totalAllocations,
+    registry.storage<Type>().capacity() * sizeof(entt::entity)};
+}
+
+// Route a component type's registry storage through its counting resource.
+// Must be used at global scope, after the component is defined and before
+// any registry touches it.
+#define TRACK_COMPONENT_MEMORY(Type)                                        \
+  template <>                                                               \
+  inline CountingResource& ComponentMemory<Type>::resource() {              \
+    static CountingResource resource(#Type);                                \
+    return resource;                                                        \
+  }                                                                         \
+  template <>                                                               \
+  struct entt::storage_type<Type, entt::entity, std::allocator<Type>> {     \
+    using type = entt::sigh_storage_mixin<                                  \
+      entt::basic_storage<Type, entt::entity, ComponentAllocator<Type, Type>>>; \
+  };
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef OVERLAY
+#define OVERLAY
+
+#include <raylib.h>
+#include <rlgl.h>
+
+#include "ailod.hpp"
+#include "alloctrack.hpp"
+#include "arena.hpp"
+#include "components.hpp"
+#include "cull.hpp"
+#include "entt.hpp"
+#include "layers.hpp"
+#include "memtrack.hpp"
+#include "spatialsort.hpp"
+#include "spritebatch.hpp"
+#include "stats.hpp"
+
+const int OVERLAY_FONT_SIZE(10);
+const int OVERLAY_LINE_HEIGHT(12);
+const int OVERLAY_WIDTH(520);
+
+#ifdef VENDORED_RAYLIB
+const char* BATCH_UPLOAD_MODE_NAMES[] = {"subdata", "orphan", "fenced"};
+const int BATCH_VERTEX_BYTES[] = {24, int(sizeof(rlVertex2D))};
+#endif
+
+static void drawOverlayLine(
+  const char* text, const int x, int& y, const Color color = RAYWHITE
+) {
+  DrawText(text, x, y, OVERLAY_FONT_SIZE, color);
+  y += OVERLAY_LINE_HEIGHT;
+}
+
+static void drawComponentMemoryLine(
+  const ComponentMemoryStats& stats, const int x, int& y
+) {
+  drawOverlayLine(
+    TextFormat(
+      "%-26s %8.1f KiB  peak %8.1f KiB  live %5zu  total %7zu  index %6.1f KiB",
+      stats.name, stats.bytes / 1024.0f, stats.peakBytes / 1024.0f,
+      stats.allocations, stats.totalAllocations, stats.indexBytes / 1024.0f
+    ),
+    x, y
+  );
+}
+
+// Component bytes the physics tick reads or writes, for every entity it visits
+static size_t tickDataBytes(entt::registry& registry) {
+  return registry.storage<CharacterComponent>().size() *
+           sizeof(CharacterComponent) +
+         registry.storage<MobComponent>().size() * sizeof(MobComponent) +
+         registry.storage<StraightMovementComponent>().size() *
+           sizeof(StraightMovementComponent) +
+         registry.storage<AILodComponent>().size() * sizeof(AILodComponent);
+}
+
+// Debug readout of per-component memory, the frame arena and live counts
+static void drawDebugOverlay(
+  entt::registry& registry, const RegistryStats& stats,
+  const FrameArena& frameArena, const SpatialSorter& spatialSorter,
+  const SpriteBatch& spriteBatch, const ViewCuller& viewCuller,
+  const double batchFlushMs, const double endDrawingMs,
+  const LayerCompositor& layers,
+  const int windowHeight
+) {
+  const int lineCount = 18;
+  int x = 10;
+  int y = windowHeight - (lineCount * OVERLAY_LINE_HEIGHT) - 10;
+
+  DrawRectangle(
+    x - 5, y - 5, OVERLAY_WIDTH, lineCount * OVERLAY_LINE_HEIGHT + 10,
+    Fade(BLACK, 0.75f)
+  );
+
+  drawOverlayLine("COMPONENT MEMORY", x, y, YELLOW);
+  drawComponentMemoryLine(componentMemoryStats<CharacterComponent>(registry), x, y);
+  drawComponentMemoryLine(componentMemoryStats<MobComponent>(registry), x, y);
+  drawComponentMemoryLine(
+    componentMemoryStats<SpawnInfoComponent>(registry), x, y
+  );
+  drawComponentMemoryLine(componentMemoryStats<TimerComponent>(registry), x, y);
+  drawComponentMemoryLine(
+    componentMemoryStats<StraightMovementComponent>(registry), x, y
+  );
+  drawComponentMemoryLine(
+    componentMemoryStats<ScoreOnKillComponent>(registry), x, y
+  );
+
+  drawOverlayLine(
+    TextFormat(
+      "Tick data: %.1f KiB  (character %zu B, mob %zu B, movement %zu B, "
+      "lod %zu B)",
+      tickDataBytes(registry) / 1024.0f, sizeof(CharacterComponent),
+      sizeof(MobComponent), sizeof(StraightMovementComponent),
+      sizeof(AILodComponent)
+    ),
+    x, y
+  );
+  drawOverlayLine(
+    TextFormat(
+      "Spatial sort: disorder %.2f  sorts %d", spatialSorter.lastDisorder,
+      spatialSorter.sorts
+    ),
+    x, y
+  );
+  drawOverlayLine(
+    TextFormat(
+      "Sprite batch: %zu sprites  %zu texture runs  (%zu unsorted, %zu saved)",
+      spriteBatch.lastSprites, spriteBatch.lastRuns,
+      spriteBatch.lastUnsortedRuns,
+      spriteBatch.lastUnsortedRuns - spriteBatch.lastRuns
+    ),
+    x, y
+  );
+#ifdef VENDORED_RAYLIB
+  drawOverlayLine(
+    TextFormat(
+      "Batch upload: %s, %d buffers, %d B/vertex  flush %.3f ms  EndDrawing "
+      "%.3f ms",
+      BATCH_UPLOAD_MODE_NAMES[rlGetBatchUploadMode()], RL_DEFAULT_BATCH_BUFFERS,
+      BATCH_VERTEX_BYTES[rlGetBatchVertexFormat()], batchFlushMs, endDrawingMs
+    ),
+    x, y
+  );
+#else
+  drawOverlayLine(
+    TextFormat(
+      "Batch upload: prebuilt raylib  flush %.3f ms  EndDrawing %.3f ms",
+      batchFlushMs, endDrawingMs
+    ),
+    x, y
+  );
+#endif
+  drawOverlayLine(
+    TextFormat(
+      "Layer renders in the last %u frames: %s %u (%u total)  %s %u (%u "
+      "total)  %s %u (%u total)",
+      layers.lastSecondFrames, SCREEN_LAYER_NAMES[SCREEN_LAYER_FLOOR],
+      layers.layers[SCREEN_LAYER_FLOOR].lastSecondRenders,
+      layers.layers[SCREEN_LAYER_FLOOR].renders,
+      SCREEN_LAYER_NAMES[SCREEN_LAYER_HUD],
+      layers.layers[SCREEN_LAYER_HUD].lastSecondRenders,
+      layers.layers[SCREEN_LAYER_HUD].renders,
+      SCREEN_LAYER_NAMES[SCREEN_LAYER_FROZEN],
+      layers.layers[SCREEN_LAYER_FROZEN].lastSecondRenders,
+      layers.layers[SCREEN_LAYER_FROZEN].renders
+    ),
+    x, y
+  );
+  drawOverlayLine(
+    TextFormat(
+      "View culling: %zu of %zu mobs and bullets drawn",
+      viewCuller.lastVisible, viewCuller.lastTotal
+    ),
+    x, y
+  );
+  drawOverlayLine(
+    TextFormat(
+      "Frame arena: last tick %zu B  peak %zu B  of %zu B",
+      frameArena.lastTickBytes, frameArena.highWaterMark, frameArena.capacity
+    ),
+    x, y
+  );
+  drawOverlayLine(
+    TextFormat(
+      "Live: melee %d  ranged %d  bullets %d  friendly %d",
+      stats.live[MELEE], stats.live[RANGE], stats.live[BULLET],
+      stats.live[FRIENDLY_BULLET]
+    ),
+    x, y
+  );
+  drawOverlayLine(
+    TextFormat(
+      "Enemies spawned %d  destroyed %d", stats.enemiesSpawned(),
+      stats.enemiesDestroyed()
+    ),
+    x, y
+  );
+
+  AllocationCounts allocations = allocationTracker.lastFrameTotal();
+  const AllocationCounts* bySubsystem = allocationTracker.lastFrame;
+  drawOverlayLine(
+    TextFormat(
+      "Heap allocations last frame: %zu  (%.1f KiB)  in zero-allocation "
+      "ticks %zu",
+      allocations.allocations, allocations.bytes / 1024.0f,
+      allocationTracker.forbiddenAllocations
+    ),
+    x, y, allocationTracker.forbiddenAllocations ? RED : RAYWHITE
+  );
+  drawOverlayLine(
+    TextFormat(
+      "  sim %zu  rollback %zu  spawn %zu  events %zu  ui %zu  render %zu  "
+      "other %zu",
+      bySubsystem[ALLOC_SIMULATION].allocations,
+      bySubsystem[ALLOC_ROLLBACK].allocations,
+      bySubsystem[ALLOC_SPAWNING].allocations,
+      bySubsystem[ALLOC_EVENTS].allocations, bySubsystem[ALLOC_UI].allocations,
+      bySubsystem[ALLOC_RENDERING].allocations,
+      bySubsystem[ALLOC_OTHER].allocations
+    ),
+    x, y
+  );
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef PIPELINE
+#define PIPELINE
+
+#include <type_traits>
+
+#include "entt.hpp"
+
+// What a system touches, as component or resource types. A system declares
+//   using reads = Reads<...>;
+//   using writes = Writes<...>;
+//   static void run(Context& context);
+// Systems that create or destroy entities list entt::registry in writes.
+template <typename... Type>
+struct Reads {};
+
+template <typename... Type>
+struct Writes {};
+
+template <typename Type, typename List>
+struct listContains;
+
+template <typename Type, template <typename...> class List, typename... Types>
+struct listContains<Type, List<Types...>>
+    : std::disjunction<std::is_same<Type, Types>...> {};
+
+// True if any type of First is also in Second
+template <typename First, typename Second>
+struct listsOverlap;
+
+template <template <typename...> class List, typename... Types, typename Second>
+struct listsOverlap<List<Types...>, Second>
+    : std::disjunction<listContains<Types, Second>...> {};
+
+// Every system implicitly reads the registry, so one that changes which
+// entities exist conflicts with everything else in its stage
+template <typename Reads>
+struct withRegistry;
+
+template <typename... Type>
+struct withRegistry<Reads<Type...>> {
+  using type = Reads<Type..., entt::registry>;
+};
+
+template <typename System>
+using systemReads = typename withRegistry<typename System::reads>::type;
+
+template <typename A, typename B>
+struct systemsConflict
+    : std::disjunction<
+        listsOverlap<typename A::writes, typename B::writes>,
+        listsOverlap<typename A::writes, systemReads<B>>,
+        listsOverlap<typename B::writes, systemReads<A>>> {};
+
+// Systems that touch disjoint data and so could run in any order, or at the
+// same time. Checked when the stage is instantiated.
+template <typename... Systems>
+struct Stage;
+
+template <>
+struct Stage<> {
+  template <typename Context>
+  static void run(Context&) {}
+};
+
+template <typename First, typename... Rest>
+struct Stage<First, Rest...> {
+  static_assert(
+    !std::disjunction_v<systemsConflict<First, Rest>...>,
+    "A system writes data that another system in the same stage uses"
+  );
+
+  template <typename Context>
+  static void run(Context& context) {
+    First::run(context);
+    Stage<Rest...>::run(context);
+  }
+};
+
+// Stages run one after another, in order. Everything is resolved at compile
+// time, running a pipeline is a sequence of direct calls.
+template <typename... Stages>
+struct Pipeline {
+  template <typename Context>
+  static void run(Context& context) {
+    (Stages::run(context), ...);
+  }
+};
+
+#endif
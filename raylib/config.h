@@ -96,7 +96,12 @@
 //#define RLGL_SHOW_GL_DETAILS_INFO              1
 
 //#define RL_DEFAULT_BATCH_BUFFER_ELEMENTS    4096    // Default internal render batch elements limits
-#define RL_DEFAULT_BATCH_BUFFERS               1      // Default number of batch buffers (multi-buffering)
+#define RL_DEFAULT_BATCH_BUFFERS               3      // Default number of batch buffers (multi-buffering)
+#define RL_DEFAULT_BATCH_UPLOAD_MODE           2      // Default render batch upload path: 0 subdata, 1 orphan, 2 fenced (rlBatchUploadMode)
+// NOTE: The compact 2D layout (1) drops the vertex depth and clamps texcoords to [0..1], so
+// depth-tested 2D, 3D shapes drawn through the batch and repeating texcoords draw wrong with it.
+// Left at the default layout, programs that only draw 2D turn it on with rlSetBatchVertexFormat()
+#define RL_DEFAULT_BATCH_VERTEX_FORMAT         0      // Default render batch vertex layout: 0 default, 1 compact 2D (rlBatchVertexFormat)
 #define RL_DEFAULT_BATCH_DRAWCALLS           256      // Default number of batch draw calls (by state changes: mode, texture)
 #define RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS     4      // Maximum number of textures units that can be activated on batch drawing (SetShaderValueTexture())
 
@@ -284,6 +284,10 @@
     #include <emscripten/html5.h>       // Emscripten HTML5 library
 #endif
 
+#if defined(SUPPORT_GIF_RECORDING) && !defined(_WIN32)
+    #include <pthread.h>                // POSIX threads management (GIF frames encoding)
+#endif
+
 //----------------------------------------------------------------------------------
 // Defines and Macros
 //----------------------------------------------------------------------------------
@@ -330,6 +334,17 @@
     #define MAX_DECOMPRESSION_SIZE        64        // Maximum size allocated for decompression in MB
 #endif
 
+#if defined(SUPPORT_GIF_RECORDING)
+    #define GIF_RECORD_FRAMERATE          10        // Game frames per recorded gif frame
+    #define GIF_FRAME_DELAY               10        // Recorded gif frame duration, in centiseconds
+    #ifndef GIF_CAPTURE_SLOTS
+        #define GIF_CAPTURE_SLOTS          4        // Maximum gif frames between screen read and encoding end
+    #endif
+    #ifndef GIF_READBACK_DELAY
+        #define GIF_READBACK_DELAY         2        // Game frames between starting a screen read and mapping its data
+    #endif
+#endif
+
 // Flags operation macros
 #define FLAG_SET(n, f) ((n) |= (f))
 #define FLAG_CLEAR(n, f) ((n) &= ~(f))
@@ -492,6 +507,34 @@ typedef struct CoreData {
     } Time;
 } CoreData;
 
+#if defined(SUPPORT_GIF_RECORDING)
+// GIF capture slot, one recorded frame on its way from the screen to the encoder
+typedef struct GifCaptureSlot {
+    unsigned int pixelBuffer;               // Pixel buffer id, 0 if not supported (frame read synchronously)
+    unsigned char *pixels;                  // Mapped pixel buffer data or read screen pixels copy
+    int pitch;                              // Bytes per row, negative for bottom-up pixel buffer rows
+    int delay;                              // Frame duration, in centiseconds
+    int readFrame;                          // GIF frames counter value when the screen read started
+} GifCaptureSlot;
+
+// GIF recording encoder state
+// NOTE: Slots are used as a ring, every cursor follows the previous one:
+// [releaseNext, encodeNext) encoded, [encodeNext, mapNext) queued, [mapNext, captureNext) reading
+typedef struct GifEncoder {
+    int width;                              // Recorded frame width
+    int height;                             // Recorded frame height
+    GifCaptureSlot slots[GIF_CAPTURE_SLOTS];    // Capture slots ring
+    unsigned int captureNext;               // Next slot to read the screen into
+    unsigned int mapNext;                   // Next slot to map and queue for encoding
+    unsigned int encodeNext;                // Next slot to encode (written by encoding thread, under lock)
+    unsigned int releaseNext;               // Next slot to unmap or free after encoding
+    int pendingDelay;                       // Duration of dropped frames, added to the next recorded one
+    int droppedFrames;                      // Frames dropped because all slots were busy
+    bool threaded;                          // Encoding thread running, otherwise frames are encoded when queued
+    bool stop;                              // Encoding thread requested to encode queued frames and exit (under lock)
+} GifEncoder;
+#endif
+
 //----------------------------------------------------------------------------------
 // Global Variables Definition
 //----------------------------------------------------------------------------------
@@ -507,6 +550,16 @@ static int screenshotCounter = 0;           // Screenshots counter
 static int gifFrameCounter = 0;             // GIF frames counter
 static bool gifRecording = false;           // GIF recording state
 static MsfGifState gifState = { 0 };        // MSGIF context state
+static GifEncoder gifEncoder = { 0 };       // GIF frames capture and encoding state
+#if defined(_WIN32)
+static void *gifThread = NULL;              // GIF encoding thread handle
+static void *gifLock = NULL;                // GIF encoder lock (SRWLOCK)
+static void *gifCondition = NULL;           // GIF encoder queue condition (CONDITION_VARIABLE)
+#else
+static pthread_t gifThread;                 // GIF encoding thread id
+static pthread_mutex_t gifLock = PTHREAD_MUTEX_INITIALIZER;     // GIF encoder lock
+static pthread_cond_t gifCondition = PTHREAD_COND_INITIALIZER;  // GIF encoder queue condition
+#endif
 #endif
 
 #if defined(SUPPORT_EVENTS_AUTOMATION)
@@ -616,6 +669,12 @@ static void SetupViewport(int width, int height);       // Set viewport for a pr
 static void ScanDirectoryFiles(const char *basePath, FilePathList *list, const char *filter);   // Scan all files and directories in a base path
 static void ScanDirectoryFilesRecursively(const char *basePath, FilePathList *list, const char *filter);  // Scan all files and directories recursively from a base path
 
+#if defined(SUPPORT_GIF_RECORDING)
+static void GifEncoderStart(int width, int height);     // Start GIF recording: pixel buffers and encoding thread
+static void GifEncoderUpdate(bool capture);             // Move recorded frames towards the encoder, read current screen if requested
+static MsfGifResult GifEncoderStop(void);               // Encode remaining frames and finish GIF recording
+#endif
+
 #if defined(PLATFORM_DESKTOP) || defined(PLATFORM_WEB)
 static void ErrorCallback(int error, const char *description);                             // GLFW3 Error Callback, runs on GLFW3 error
 // Window callbacks events
@@ -683,6 +742,16 @@ static void PlayAutomationEvent(unsigned int frame);        // Play frame events
 #if defined(_WIN32)
 // NOTE: We declare Sleep() function symbol to avoid including windows.h (kernel32.lib linkage required)
 void __stdcall Sleep(unsigned long msTimeout);              // Required for: WaitTime()
+#if defined(SUPPORT_GIF_RECORDING)
+// NOTE: Same for threads management functions, required for GIF frames encoding
+void *__stdcall CreateThread(void *threadAttributes, size_t stackSize, unsigned long (__stdcall *startAddress)(void *), void *parameter, unsigned long creationFlags, unsigned long *threadId);
+unsigned long __stdcall WaitForSingleObject(void *handle, unsigned long milliseconds);
+int __stdcall CloseHandle(void *handle);
+void __stdcall AcquireSRWLockExclusive(void **lock);
+void __stdcall ReleaseSRWLockExclusive(void **lock);
+int __stdcall SleepConditionVariableSRW(void **condition, void **lock, unsigned long milliseconds, unsigned long flags);
+void __stdcall WakeConditionVariable(void **condition);
+#endif
 #endif
 
 #if !defined(SUPPORT_MODULE_RTEXT)
@@ -926,7 +995,7 @@ void CloseWindow(void)
 #if defined(SUPPORT_GIF_RECORDING)
     if (gifRecording)
     {
-        MsfGifResult result = msf_gif_end(&gifState);
+        MsfGifResult result = GifEncoderStop();
         msf_gif_free(result);
         gifRecording = false;
     }
@@ -2035,20 +2104,11 @@ void EndDrawing(void)
     // Draw record indicator
     if (gifRecording)
     {
-        #define GIF_RECORD_FRAMERATE    10
         gifFrameCounter++;
 
-        // NOTE: We record one gif frame every 10 game frames
-        if ((gifFrameCounter%GIF_RECORD_FRAMERATE) == 0)
-        {
-            // Get image data for the current frame (from backbuffer)
-            // NOTE: This process is quite slow... :(
-            Vector2 scale = GetWindowScaleDPI();
-            unsigned char *screenData = rlReadScreenPixels((int)((float)CORE.Window.render.width*scale.x), (int)((float)CORE.Window.render.height*scale.y));
-            msf_gif_frame(&gifState, screenData, 10, 16, (int)((float)CORE.Window.render.width*scale.x)*4);
-
-            RL_FREE(screenData);    // Free image data
-        }
+        // NOTE: We record one gif frame every 10 game frames, read from the backbuffer
+        // before the indicator is drawn, and encoded out of the frame (see GifEncoderUpdate())
+        GifEncoderUpdate((gifFrameCounter%GIF_RECORD_FRAMERATE) == 0);
 
     #if defined(SUPPORT_MODULE_RSHAPES) && defined(SUPPORT_MODULE_RTEXT)
         if (((gifFrameCounter/15)%2) == 1)
@@ -5197,6 +5257,226 @@ static void ScanDirectoryFilesRecursively(const char *basePath, FilePathList *fi
     else TRACELOG(LOG_WARNING, "FILEIO: Directory cannot be opened (%s)", basePath);
 }
 
+#if defined(SUPPORT_GIF_RECORDING)
+// GIF encoder lock and queue condition, the encoding thread is the only waiter
+static void GifEncoderLock(void)
+{
+#if defined(_WIN32)
+    AcquireSRWLockExclusive(&gifLock);
+#else
+    pthread_mutex_lock(&gifLock);
+#endif
+}
+
+static void GifEncoderUnlock(void)
+{
+#if defined(_WIN32)
+    ReleaseSRWLockExclusive(&gifLock);
+#else
+    pthread_mutex_unlock(&gifLock);
+#endif
+}
+
+static void GifEncoderWait(void)
+{
+#if defined(_WIN32)
+    SleepConditionVariableSRW(&gifCondition, &gifLock, 0xFFFFFFFF, 0);    // INFINITE
+#else
+    pthread_cond_wait(&gifCondition, &gifLock);
+#endif
+}
+
+static void GifEncoderSignal(void)
+{
+#if defined(_WIN32)
+    WakeConditionVariable(&gifCondition);
+#else
+    pthread_cond_signal(&gifCondition);
+#endif
+}
+
+// Encode one recorded frame, frames that could not be read are skipped
+static void GifEncoderFrame(GifCaptureSlot *slot)
+{
+    if (slot->pixels != NULL) msf_gif_frame(&gifState, slot->pixels, slot->delay, 16, slot->pitch);
+}
+
+// GIF encoding thread, encodes queued frames in order until stopped
+#if defined(_WIN32)
+static unsigned long __stdcall GifEncoderThread(void *arg)
+#else
+static void *GifEncoderThread(void *arg)
+#endif
+{
+    GifEncoderLock();
+
+    while (true)
+    {
+        while ((gifEncoder.encodeNext == gifEncoder.mapNext) && !gifEncoder.stop) GifEncoderWait();
+        if (gifEncoder.encodeNext == gifEncoder.mapNext) break;     // Stopped and nothing left queued
+
+        GifCaptureSlot *slot = &gifEncoder.slots[gifEncoder.encodeNext%GIF_CAPTURE_SLOTS];
+
+        // NOTE: Main thread does not touch queued slots or gifState, no need to hold the lock
+        GifEncoderUnlock();
+        GifEncoderFrame(slot);
+        GifEncoderLock();
+
+        gifEncoder.encodeNext++;
+    }
+
+    GifEncoderUnlock();
+
+    return 0;
+}
+
+// Start GIF recording: pixel buffers and encoding thread
+// NOTE: Without pixel buffers frames are read synchronously, without thread they are encoded when queued
+static void GifEncoderStart(int width, int height)
+{
+    memset(&gifEncoder, 0, sizeof(GifEncoder));
+    gifEncoder.width = width;
+    gifEncoder.height = height;
+
+    msf_gif_begin(&gifState, width, height);
+
+    for (int i = 0; i < GIF_CAPTURE_SLOTS; i++) gifEncoder.slots[i].pixelBuffer = rlLoadPixelBuffer(width*height*4);
+
+#if defined(_WIN32)
+    gifThread = CreateThread(NULL, 0, GifEncoderThread, NULL, 0, NULL);
+    gifEncoder.threaded = (gifThread != NULL);
+#else
+    gifEncoder.threaded = (pthread_create(&gifThread, NULL, GifEncoderThread, NULL) == 0);
+#endif
+
+    if (gifEncoder.slots[0].pixelBuffer == 0) TRACELOG(LOG_INFO, "SYSTEM: GIF frames read synchronously, pixel buffers not supported");
+    if (!gifEncoder.threaded) TRACELOG(LOG_WARNING, "SYSTEM: GIF encoding thread could not be created, frames encoded on main thread");
+}
+
+// Map and queue for encoding the frames being read, only the ones old enough to not stall unless all requested
+static void GifEncoderQueueReads(bool all)
+{
+    while (gifEncoder.mapNext != gifEncoder.captureNext)
+    {
+        GifCaptureSlot *slot = &gifEncoder.slots[gifEncoder.mapNext%GIF_CAPTURE_SLOTS];
+
+        if (slot->pixelBuffer != 0)
+        {
+            if (!all && ((gifFrameCounter - slot->readFrame) < GIF_READBACK_DELAY)) break;
+
+            slot->pixels = rlMapPixelBuffer(slot->pixelBuffer, gifEncoder.width*gifEncoder.height*4);
+            slot->pitch = -gifEncoder.width*4;      // Pixel buffer rows are bottom-up, msf_gif flips them
+        }
+
+        // Frame lost, keep its duration for the next one
+        if (slot->pixels == NULL) gifEncoder.pendingDelay += slot->delay;
+
+        if (gifEncoder.threaded)
+        {
+            GifEncoderLock();
+            gifEncoder.mapNext++;
+            GifEncoderSignal();
+            GifEncoderUnlock();
+        }
+        else
+        {
+            GifEncoderFrame(slot);
+            gifEncoder.mapNext++;
+            gifEncoder.encodeNext++;
+        }
+    }
+}
+
+// Unmap or free the frames already encoded
+static void GifEncoderReleaseEncoded(void)
+{
+    GifEncoderLock();
+    unsigned int encodeNext = gifEncoder.encodeNext;
+    GifEncoderUnlock();
+
+    for (; gifEncoder.releaseNext != encodeNext; gifEncoder.releaseNext++)
+    {
+        GifCaptureSlot *slot = &gifEncoder.slots[gifEncoder.releaseNext%GIF_CAPTURE_SLOTS];
+
+        if (slot->pixels != NULL)
+        {
+            if (slot->pixelBuffer != 0) rlUnmapPixelBuffer(slot->pixelBuffer);
+            else RL_FREE(slot->pixels);
+        }
+
+        slot->pixels = NULL;
+    }
+}
+
+// Move recorded frames towards the encoder, read current screen if requested
+// NOTE: Screen is read into a pixel buffer and mapped GIF_READBACK_DELAY frames later, when the GPU
+// is done with it, if all slots are busy the frame is dropped and its duration added to the next one
+static void GifEncoderUpdate(bool capture)
+{
+    GifEncoderReleaseEncoded();
+    GifEncoderQueueReads(false);
+
+    if (!capture) return;
+
+    if ((gifEncoder.captureNext - gifEncoder.releaseNext) < GIF_CAPTURE_SLOTS)
+    {
+        GifCaptureSlot *slot = &gifEncoder.slots[gifEncoder.captureNext%GIF_CAPTURE_SLOTS];
+
+        slot->delay = GIF_FRAME_DELAY + gifEncoder.pendingDelay;
+        slot->readFrame = gifFrameCounter;
+        gifEncoder.pendingDelay = 0;
+
+        if (slot->pixelBuffer != 0) rlReadScreenPixelsAsync(slot->pixelBuffer, gifEncoder.width, gifEncoder.height);
+        else
+        {
+            slot->pixels = rlReadScreenPixels(gifEncoder.width, gifEncoder.height);
+            slot->pitch = gifEncoder.width*4;
+        }
+
+        gifEncoder.captureNext++;
+    }
+    else
+    {
+        gifEncoder.pendingDelay += GIF_FRAME_DELAY;
+        gifEncoder.droppedFrames++;
+    }
+}
+
+// Encode remaining frames and finish GIF recording
+static MsfGifResult GifEncoderStop(void)
+{
+    GifEncoderQueueReads(true);
+
+    if (gifEncoder.threaded)
+    {
+        GifEncoderLock();
+        gifEncoder.stop = true;
+        GifEncoderSignal();
+        GifEncoderUnlock();
+
+    #if defined(_WIN32)
+        WaitForSingleObject(gifThread, 0xFFFFFFFF);     // INFINITE
+        CloseHandle(gifThread);
+        gifThread = NULL;
+    #else
+        pthread_join(gifThread, NULL);
+    #endif
+        gifEncoder.threaded = false;
+    }
+
+    GifEncoderReleaseEncoded();
+
+    for (int i = 0; i < GIF_CAPTURE_SLOTS; i++)
+    {
+        if (gifEncoder.slots[i].pixelBuffer != 0) rlUnloadPixelBuffer(gifEncoder.slots[i].pixelBuffer);
+    }
+
+    if (gifEncoder.droppedFrames > 0) TRACELOG(LOG_INFO, "SYSTEM: GIF recording dropped %i frames, encoding fell behind", gifEncoder.droppedFrames);
+
+    return msf_gif_end(&gifState);
+}
+#endif  // SUPPORT_GIF_RECORDING
+
 #if defined(PLATFORM_DESKTOP) || defined(PLATFORM_WEB)
 // GLFW3 Error Callback, runs on GLFW3 error
 static void ErrorCallback(int error, const char *description)
@@ -5293,7 +5573,7 @@ static void KeyCallback(GLFWwindow *window, int key, int scancode, int action, i
             {
                 gifRecording = false;
 
-                MsfGifResult result = msf_gif_end(&gifState);
+                MsfGifResult result = GifEncoderStop();
 
                 SaveFileData(TextFormat("%s/screenrec%03i.gif", CORE.Storage.basePath, screenshotCounter), result.data, (unsigned int)result.dataSize);
                 msf_gif_free(result);
@@ -5312,7 +5592,7 @@ static void KeyCallback(GLFWwindow *window, int key, int scancode, int action, i
                 gifFrameCounter = 0;
 
                 Vector2 scale = GetWindowScaleDPI();
-                msf_gif_begin(&gifState, (int)((float)CORE.Window.render.width*scale.x), (int)((float)CORE.Window.render.height*scale.y));
+                GifEncoderStart((int)((float)CORE.Window.render.width*scale.x), (int)((float)CORE.Window.render.height*scale.y));
                 screenshotCounter++;
 
                 TRACELOG(LOG_INFO, "SYSTEM: Start animated GIF recording: %s", TextFormat("screenrec%03i.gif", screenshotCounter));
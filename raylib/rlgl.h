@@ -50,6 +50,8 @@
 *
 *   #define RL_DEFAULT_BATCH_BUFFER_ELEMENTS   8192    // Default internal render batch elements limits
 *   #define RL_DEFAULT_BATCH_BUFFERS              1    // Default number of batch buffers (multi-buffering)
+*   #define RL_DEFAULT_BATCH_UPLOAD_MODE          0    // Default render batch upload path (rlBatchUploadMode)
+*   #define RL_DEFAULT_BATCH_VERTEX_FORMAT        0    // Default render batch vertex layout (rlBatchVertexFormat)
 *   #define RL_DEFAULT_BATCH_DRAWCALLS          256    // Default number of batch draw calls (by state changes: mode, texture)
 *   #define RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS    4    // Maximum number of textures units that can be activated on batch drawing (SetShaderValueTexture())
 *
@@ -205,6 +207,12 @@
 #ifndef RL_DEFAULT_BATCH_BUFFERS
     #define RL_DEFAULT_BATCH_BUFFERS                 1      // Default number of batch buffers (multi-buffering)
 #endif
+#ifndef RL_DEFAULT_BATCH_UPLOAD_MODE
+    #define RL_DEFAULT_BATCH_UPLOAD_MODE             0      // Default render batch upload path (rlBatchUploadMode)
+#endif
+#ifndef RL_DEFAULT_BATCH_VERTEX_FORMAT
+    #define RL_DEFAULT_BATCH_VERTEX_FORMAT           0      // Default render batch vertex layout (rlBatchVertexFormat)
+#endif
 #ifndef RL_DEFAULT_BATCH_DRAWCALLS
     #define RL_DEFAULT_BATCH_DRAWCALLS             256      // Default number of batch draw calls (by state changes: mode, texture)
 #endif
@@ -314,6 +322,30 @@ typedef enum {
     RL_ATTACHMENT_RENDERBUFFER = 200,
 } rlFramebufferAttachTextureType;
 
+// Render batch vertex data upload path, set with rlSetBatchUploadMode() before rlglInit()
+// NOTE: RL_BATCH_UPLOAD_FENCED only pays off with RL_DEFAULT_BATCH_BUFFERS > 1, so the
+// buffer being written is not the one the GPU is still reading
+typedef enum {
+    RL_BATCH_UPLOAD_SUBDATA = 0,        // glBufferSubData() into the buffer, may stall while the GPU still reads it
+    RL_BATCH_UPLOAD_ORPHAN,             // glBufferData(NULL) first, the driver hands back fresh storage
+    RL_BATCH_UPLOAD_FENCED,             // Wait on the buffer fence and write unsynchronized, persistently mapped if supported (GL 3.3)
+} rlBatchUploadMode;
+
+// Render batch vertex layout, set with rlSetBatchVertexFormat() before the batch is loaded
+// NOTE: RL_BATCH_VERTEX_2D drops the depth rlVertex2f() adds, so 2D draws with depth testing
+// enabled and 3D shapes drawn through the batch (DrawCube()...) do not work with it
+typedef enum {
+    RL_BATCH_VERTEX_DEFAULT = 0,        // Separate position (XYZ float), texcoord (UV float) and color arrays, 24 bytes by vertex
+    RL_BATCH_VERTEX_2D,                 // Interleaved rlVertex2D, 16 bytes by vertex, texcoords clamped to [0..1]
+} rlBatchVertexFormat;
+
+// Compact interleaved vertex (RL_BATCH_VERTEX_2D)
+typedef struct rlVertex2D {
+    float x, y;                 // Vertex position (XY) (shader-location = 0)
+    unsigned short u, v;        // Vertex texture coordinates, unsigned normalized (shader-location = 1)
+    unsigned char r, g, b, a;   // Vertex color (RGBA) (shader-location = 3)
+} rlVertex2D;
+
 // Dynamic vertex buffers (position + texcoords + colors + indices arrays)
 typedef struct rlVertexBuffer {
     int elementCount;           // Number of elements in the buffer (QUADS)
@@ -321,6 +353,7 @@ typedef struct rlVertexBuffer {
     float *vertices;            // Vertex position (XYZ - 3 components per vertex) (shader-location = 0)
     float *texcoords;           // Vertex texture coordinates (UV - 2 components per vertex) (shader-location = 1)
     unsigned char *colors;      // Vertex colors (RGBA - 4 components per vertex) (shader-location = 3)
+    rlVertex2D *vertices2D;     // Interleaved vertex data, replaces the three arrays above (RL_BATCH_VERTEX_2D)
 #if defined(GRAPHICS_API_OPENGL_11) || defined(GRAPHICS_API_OPENGL_33)
     unsigned int *indices;      // Vertex indices (in case vertex data comes indexed) (6 indices per quad)
 #endif
@@ -329,6 +362,8 @@ typedef struct rlVertexBuffer {
 #endif
     unsigned int vaoId;         // OpenGL Vertex Array Object id
     unsigned int vboId[4];      // OpenGL Vertex Buffer Objects id (4 types of vertex data)
+    void *mapped[3];            // Persistently mapped position, texcoord and color buffers (RL_BATCH_UPLOAD_FENCED), only the first one with RL_BATCH_VERTEX_2D
+    void *fence;                // Sync object set after the buffer was last drawn (RL_BATCH_UPLOAD_FENCED)
 } rlVertexBuffer;
 
 // Draw call type
@@ -352,6 +387,7 @@ typedef struct rlRenderBatch {
     int bufferCount;            // Number of vertex buffers (multi-buffering support)
     int currentBuffer;          // Current buffer tracking in case of multi-buffering
     rlVertexBuffer *vertexBuffer; // Dynamic buffer(s) for vertex data
+    int vertexFormat;           // Vertex layout of the buffers (rlBatchVertexFormat)
 
     rlDrawCall *draws;          // Draw calls array, depends on textureId
     int drawCounter;            // Draw calls counter
@@ -616,6 +652,10 @@ RLAPI void rlDrawRenderBatch(rlRenderBatch *batch);                         // D
 RLAPI void rlSetRenderBatchActive(rlRenderBatch *batch);                    // Set the active render batch for rlgl (NULL for default internal)
 RLAPI void rlDrawRenderBatchActive(void);                                   // Update and draw internal render batch
 RLAPI bool rlCheckRenderBatchLimit(int vCount);                             // Check internal buffer overflow for a given number of vertex
+RLAPI void rlSetBatchUploadMode(int mode);                                  // Set render batch upload path (rlBatchUploadMode), call before rlglInit()
+RLAPI int rlGetBatchUploadMode(void);                                       // Get render batch upload path in use, fenced falls back if unsupported
+RLAPI void rlSetBatchVertexFormat(int format);                              // Set vertex layout of render batches loaded afterwards (rlBatchVertexFormat)
+RLAPI int rlGetBatchVertexFormat(void);                                     // Get vertex layout render batches are loaded with
 RLAPI void rlSetTexture(unsigned int id);           // Set current texture for render batch and check buffers limits
 
 //------------------------------------------------------------------------------------------------------------------------
@@ -647,6 +687,11 @@ RLAPI void rlUnloadTexture(unsigned int id);                              // Unl
 RLAPI void rlGenTextureMipmaps(unsigned int id, int width, int height, int format, int *mipmaps); // Generate mipmap data for selected texture
 RLAPI void *rlReadTexturePixels(unsigned int id, int width, int height, int format);              // Read texture pixel data
 RLAPI unsigned char *rlReadScreenPixels(int width, int height);           // Read screen pixel data (color buffer)
+RLAPI unsigned int rlLoadPixelBuffer(int size);                           // Load pixel buffer for asynchronous screen reads, 0 if not supported (OpenGL 3.3)
+RLAPI void rlUnloadPixelBuffer(unsigned int id);                          // Unload pixel buffer
+RLAPI void rlReadScreenPixelsAsync(unsigned int id, int width, int height); // Start reading screen pixel data into a pixel buffer, returns without waiting
+RLAPI unsigned char *rlMapPixelBuffer(unsigned int id, int size);         // Map pixel buffer data for reading (RGBA, bottom-up rows), waits for an unfinished read
+RLAPI void rlUnmapPixelBuffer(unsigned int id);                           // Unmap pixel buffer
 
 // Framebuffer management (fbo)
 RLAPI unsigned int rlLoadFramebuffer(int width, int height);              // Load an empty framebuffer
@@ -762,7 +807,7 @@ RLAPI void rlLoadDrawQuad(void);     // Load and draw a quad
 #endif
 
 #include <stdlib.h>                     // Required for: malloc(), free()
-#include <string.h>                     // Required for: strcmp(), strlen() [Used in rlglInit(), on extensions loading]
+#include <string.h>                     // Required for: strcmp(), strlen() [Used in rlglInit(), on extensions loading], memcpy()
 #include <math.h>                       // Required for: sqrtf(), sinf(), cosf(), floor(), log()
 
 //----------------------------------------------------------------------------------
@@ -966,6 +1011,9 @@ typedef void *(*rlglLoadProc)(const char *name);   // OpenGL extension functions
 static rlglData RLGL = { 0 };
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
 
+static int rlBatchUploadModeActive = RL_DEFAULT_BATCH_UPLOAD_MODE;     // Render batch upload path, resolved on rlglInit()
+static int rlBatchVertexFormatActive = RL_DEFAULT_BATCH_VERTEX_FORMAT; // Render batch vertex layout, used by rlLoadRenderBatch()
+
 #if defined(GRAPHICS_API_OPENGL_ES2)
 // NOTE: VAO functionality is exposed through extensions (OES)
 static PFNGLGENVERTEXARRAYSOESPROC glGenVertexArrays = NULL;
@@ -984,6 +1032,14 @@ static PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisor = NULL;
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 static void rlLoadShaderDefault(void);      // Load default shader
 static void rlUnloadShaderDefault(void);    // Unload default shader
+static bool rlBatchFencesSupported(void);   // Check sync objects and buffer mapping are available for fenced batch uploads
+static void rlLoadBatchBufferStorage(rlVertexBuffer *buffer, int index, int size, const void *data);   // Create a batch vertex buffer storage (buffer bound)
+static void rlUploadBatchBuffer(rlVertexBuffer *buffer, int index, int fullSize, int size, const void *data); // Upload batch vertex data (buffer bound)
+#if defined(GRAPHICS_API_OPENGL_33)
+static void rlWaitBatchFence(rlVertexBuffer *buffer);   // Wait for the GPU to be done with a batch vertex buffer
+#endif
+static void rlSetBatchVertex2DAttribs(void);            // Set interleaved vertex attributes of a batch vertex buffer (buffer bound)
+static unsigned short rlPackTexcoord(float t);          // Convert a texture coordinate to unsigned normalized short
 #if defined(RLGL_SHOW_GL_DETAILS_INFO)
 static char *rlGetCompressedFormatName(int format); // Get compressed format official GL identifier name
 #endif  // RLGL_SHOW_GL_DETAILS_INFO
@@ -1338,23 +1394,39 @@ void rlVertex3f(float x, float y, float z)
     // Verify that current vertex buffer elements limit has not been reached
     if (RLGL.State.vertexCounter < (RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].elementCount*4))
     {
-        // Add vertices
-        RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter] = tx;
-        RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter + 1] = ty;
-        RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter + 2] = tz;
-
-        // Add current texcoord
-        RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].texcoords[2*RLGL.State.vertexCounter] = RLGL.State.texcoordx;
-        RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].texcoords[2*RLGL.State.vertexCounter + 1] = RLGL.State.texcoordy;
-
-        // TODO: Add current normal
-        // By default rlVertexBuffer type does not store normals
-
-        // Add current color
-        RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].colors[4*RLGL.State.vertexCounter] = RLGL.State.colorr;
-        RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].colors[4*RLGL.State.vertexCounter + 1] = RLGL.State.colorg;
-        RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].colors[4*RLGL.State.vertexCounter + 2] = RLGL.State.colorb;
-        RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].colors[4*RLGL.State.vertexCounter + 3] = RLGL.State.colora;
+        if (RLGL.currentBatch->vertexFormat == RL_BATCH_VERTEX_2D)
+        {
+            // Add vertex position, texcoord and color interleaved, depth is dropped
+            rlVertex2D *vertex = &RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices2D[RLGL.State.vertexCounter];
+            vertex->x = tx;
+            vertex->y = ty;
+            vertex->u = rlPackTexcoord(RLGL.State.texcoordx);
+            vertex->v = rlPackTexcoord(RLGL.State.texcoordy);
+            vertex->r = RLGL.State.colorr;
+            vertex->g = RLGL.State.colorg;
+            vertex->b = RLGL.State.colorb;
+            vertex->a = RLGL.State.colora;
+        }
+        else
+        {
+            // Add vertices
+            RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter] = tx;
+            RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter + 1] = ty;
+            RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter + 2] = tz;
+
+            // Add current texcoord
+            RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].texcoords[2*RLGL.State.vertexCounter] = RLGL.State.texcoordx;
+            RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].texcoords[2*RLGL.State.vertexCounter + 1] = RLGL.State.texcoordy;
+
+            // TODO: Add current normal
+            // By default rlVertexBuffer type does not store normals
+
+            // Add current color
+            RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].colors[4*RLGL.State.vertexCounter] = RLGL.State.colorr;
+            RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].colors[4*RLGL.State.vertexCounter + 1] = RLGL.State.colorg;
+            RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].colors[4*RLGL.State.vertexCounter + 2] = RLGL.State.colorb;
+            RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].colors[4*RLGL.State.vertexCounter + 3] = RLGL.State.colora;
+        }
 
         RLGL.State.vertexCounter++;
 
@@ -1908,6 +1980,13 @@ void rlglInit(int width, int height)
     RLGL.State.currentShaderId = RLGL.State.defaultShaderId;
     RLGL.State.currentShaderLocs = RLGL.State.defaultShaderLocs;
 
+    // Fenced uploads need sync objects and buffer mapping (OpenGL 3.2), fall back to orphaning without them
+    if ((rlBatchUploadModeActive == RL_BATCH_UPLOAD_FENCED) && !rlBatchFencesSupported())
+    {
+        TRACELOG(RL_LOG_WARNING, "RLGL: Fenced batch uploads not supported, orphaning buffers instead");
+        rlBatchUploadModeActive = RL_BATCH_UPLOAD_ORPHAN;
+    }
+
     // Init default vertex arrays buffers
     RLGL.defaultBatch = rlLoadRenderBatch(RL_DEFAULT_BATCH_BUFFERS, RL_DEFAULT_BATCH_BUFFER_ELEMENTS);
     RLGL.currentBatch = &RLGL.defaultBatch;
@@ -2305,14 +2384,31 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
     // Initialize CPU (RAM) vertex buffers (position, texcoord, color data and indexes)
     //--------------------------------------------------------------------------------------------
     batch.vertexBuffer = (rlVertexBuffer *)RL_MALLOC(numBuffers*sizeof(rlVertexBuffer));
+    batch.vertexFormat = rlBatchVertexFormatActive;
 
     for (int i = 0; i < numBuffers; i++)
     {
         batch.vertexBuffer[i].elementCount = bufferElements;
 
-        batch.vertexBuffer[i].vertices = (float *)RL_MALLOC(bufferElements*3*4*sizeof(float));        // 3 float by vertex, 4 vertex by quad
-        batch.vertexBuffer[i].texcoords = (float *)RL_MALLOC(bufferElements*2*4*sizeof(float));       // 2 float by texcoord, 4 texcoord by quad
-        batch.vertexBuffer[i].colors = (unsigned char *)RL_MALLOC(bufferElements*4*4*sizeof(unsigned char));   // 4 float by color, 4 colors by quad
+        batch.vertexBuffer[i].vertices = NULL;
+        batch.vertexBuffer[i].texcoords = NULL;
+        batch.vertexBuffer[i].colors = NULL;
+        batch.vertexBuffer[i].vertices2D = NULL;
+
+        if (batch.vertexFormat == RL_BATCH_VERTEX_2D)
+        {
+            batch.vertexBuffer[i].vertices2D = (rlVertex2D *)RL_CALLOC(bufferElements*4, sizeof(rlVertex2D));   // 4 vertex by quad
+        }
+        else
+        {
+            batch.vertexBuffer[i].vertices = (float *)RL_MALLOC(bufferElements*3*4*sizeof(float));        // 3 float by vertex, 4 vertex by quad
+            batch.vertexBuffer[i].texcoords = (float *)RL_MALLOC(bufferElements*2*4*sizeof(float));       // 2 float by texcoord, 4 texcoord by quad
+            batch.vertexBuffer[i].colors = (unsigned char *)RL_MALLOC(bufferElements*4*4*sizeof(unsigned char));   // 4 float by color, 4 colors by quad
+
+            for (int j = 0; j < (3*4*bufferElements); j++) batch.vertexBuffer[i].vertices[j] = 0.0f;
+            for (int j = 0; j < (2*4*bufferElements); j++) batch.vertexBuffer[i].texcoords[j] = 0.0f;
+            for (int j = 0; j < (4*4*bufferElements); j++) batch.vertexBuffer[i].colors[j] = 0;
+        }
 #if defined(GRAPHICS_API_OPENGL_33)
         batch.vertexBuffer[i].indices = (unsigned int *)RL_MALLOC(bufferElements*6*sizeof(unsigned int));      // 6 int by quad (indices)
 #endif
@@ -2320,10 +2416,6 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
         batch.vertexBuffer[i].indices = (unsigned short *)RL_MALLOC(bufferElements*6*sizeof(unsigned short));  // 6 int by quad (indices)
 #endif
 
-        for (int j = 0; j < (3*4*bufferElements); j++) batch.vertexBuffer[i].vertices[j] = 0.0f;
-        for (int j = 0; j < (2*4*bufferElements); j++) batch.vertexBuffer[i].texcoords[j] = 0.0f;
-        for (int j = 0; j < (4*4*bufferElements); j++) batch.vertexBuffer[i].colors[j] = 0;
-
         int k = 0;
 
         // Indices can be initialized right now
@@ -2356,27 +2448,43 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
             glBindVertexArray(batch.vertexBuffer[i].vaoId);
         }
 
-        // Quads - Vertex buffers binding and attributes enable
-        // Vertex position buffer (shader-location = 0)
-        glGenBuffers(1, &batch.vertexBuffer[i].vboId[0]);
-        glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[0]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*3*4*sizeof(float), batch.vertexBuffer[i].vertices, GL_DYNAMIC_DRAW);
-        glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION]);
-        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION], 3, GL_FLOAT, 0, 0, 0);
-
-        // Vertex texcoord buffer (shader-location = 1)
-        glGenBuffers(1, &batch.vertexBuffer[i].vboId[1]);
-        glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[1]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*2*4*sizeof(float), batch.vertexBuffer[i].texcoords, GL_DYNAMIC_DRAW);
-        glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
-        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_FLOAT, 0, 0, 0);
-
-        // Vertex color buffer (shader-location = 3)
-        glGenBuffers(1, &batch.vertexBuffer[i].vboId[2]);
-        glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[2]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*4*4*sizeof(unsigned char), batch.vertexBuffer[i].colors, GL_DYNAMIC_DRAW);
-        glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR]);
-        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR], 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, 0);
+        if (batch.vertexFormat == RL_BATCH_VERTEX_2D)
+        {
+            // Interleaved vertex buffer (shader-location = 0, 1, 3), one buffer for all the attributes
+            glGenBuffers(1, &batch.vertexBuffer[i].vboId[0]);
+            glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[0]);
+            rlLoadBatchBufferStorage(&batch.vertexBuffer[i], 0, bufferElements*4*sizeof(rlVertex2D), batch.vertexBuffer[i].vertices2D);
+            rlSetBatchVertex2DAttribs();
+
+            batch.vertexBuffer[i].vboId[1] = 0;
+            batch.vertexBuffer[i].vboId[2] = 0;
+            batch.vertexBuffer[i].mapped[1] = NULL;
+            batch.vertexBuffer[i].mapped[2] = NULL;
+        }
+        else
+        {
+            // Quads - Vertex buffers binding and attributes enable
+            // Vertex position buffer (shader-location = 0)
+            glGenBuffers(1, &batch.vertexBuffer[i].vboId[0]);
+            glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[0]);
+            rlLoadBatchBufferStorage(&batch.vertexBuffer[i], 0, bufferElements*3*4*sizeof(float), batch.vertexBuffer[i].vertices);
+            glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION]);
+            glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION], 3, GL_FLOAT, 0, 0, 0);
+
+            // Vertex texcoord buffer (shader-location = 1)
+            glGenBuffers(1, &batch.vertexBuffer[i].vboId[1]);
+            glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[1]);
+            rlLoadBatchBufferStorage(&batch.vertexBuffer[i], 1, bufferElements*2*4*sizeof(float), batch.vertexBuffer[i].texcoords);
+            glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
+            glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_FLOAT, 0, 0, 0);
+
+            // Vertex color buffer (shader-location = 3)
+            glGenBuffers(1, &batch.vertexBuffer[i].vboId[2]);
+            glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[2]);
+            rlLoadBatchBufferStorage(&batch.vertexBuffer[i], 2, bufferElements*4*4*sizeof(unsigned char), batch.vertexBuffer[i].colors);
+            glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR]);
+            glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR], 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, 0);
+        }
 
         // Fill index buffer
         glGenBuffers(1, &batch.vertexBuffer[i].vboId[3]);
@@ -2442,7 +2550,13 @@ void rlUnloadRenderBatch(rlRenderBatch batch)
             glBindVertexArray(0);
         }
 
+#if defined(GRAPHICS_API_OPENGL_33)
+        // Persistent mappings go away with their buffers, the fence has to be deleted
+        if (batch.vertexBuffer[i].fence != NULL) glDeleteSync((GLsync)batch.vertexBuffer[i].fence);
+#endif
+
         // Delete VBOs from GPU (VRAM)
+        // NOTE: Unused ids (RL_BATCH_VERTEX_2D) are 0 and silently ignored
         glDeleteBuffers(1, &batch.vertexBuffer[i].vboId[0]);
         glDeleteBuffers(1, &batch.vertexBuffer[i].vboId[1]);
         glDeleteBuffers(1, &batch.vertexBuffer[i].vboId[2]);
@@ -2455,6 +2569,7 @@ void rlUnloadRenderBatch(rlRenderBatch batch)
         RL_FREE(batch.vertexBuffer[i].vertices);
         RL_FREE(batch.vertexBuffer[i].texcoords);
         RL_FREE(batch.vertexBuffer[i].colors);
+        RL_FREE(batch.vertexBuffer[i].vertices2D);
         RL_FREE(batch.vertexBuffer[i].indices);
     }
 
@@ -2475,23 +2590,39 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
     // TODO: If no data changed on the CPU arrays --> No need to re-update GPU arrays (change flag required)
     if (RLGL.State.vertexCounter > 0)
     {
-        // Activate elements VAO
-        if (RLGL.ExtSupported.vao) glBindVertexArray(batch->vertexBuffer[batch->currentBuffer].vaoId);
+        rlVertexBuffer *buffer = &batch->vertexBuffer[batch->currentBuffer];
 
-        // Vertex positions buffer
-        glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*3*sizeof(float), batch->vertexBuffer[batch->currentBuffer].vertices);
-        //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*3*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].vertices, GL_DYNAMIC_DRAW);  // Update all buffer
+#if defined(GRAPHICS_API_OPENGL_33)
+        // Fenced uploads write without synchronization, the GPU has to be done with the last draw from this buffer
+        if (buffer->fence != NULL) rlWaitBatchFence(buffer);
+#endif
 
-        // Texture coordinates buffer
-        glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[1]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*2*sizeof(float), batch->vertexBuffer[batch->currentBuffer].texcoords);
-        //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*2*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].texcoords, GL_DYNAMIC_DRAW); // Update all buffer
+        // Activate elements VAO
+        if (RLGL.ExtSupported.vao) glBindVertexArray(batch->vertexBuffer[batch->currentBuffer].vaoId);
 
-        // Colors buffer
-        glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[2]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*4*sizeof(unsigned char), batch->vertexBuffer[batch->currentBuffer].colors);
-        //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*4*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].colors, GL_DYNAMIC_DRAW);    // Update all buffer
+        if (batch->vertexFormat == RL_BATCH_VERTEX_2D)
+        {
+            // Interleaved vertex buffer, a single upload
+            glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
+            rlUploadBatchBuffer(buffer, 0, buffer->elementCount*4*sizeof(rlVertex2D), RLGL.State.vertexCounter*sizeof(rlVertex2D), buffer->vertices2D);
+        }
+        else
+        {
+            // Vertex positions buffer
+            glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
+            rlUploadBatchBuffer(buffer, 0, buffer->elementCount*3*4*sizeof(float), RLGL.State.vertexCounter*3*sizeof(float), buffer->vertices);
+            //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*3*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].vertices, GL_DYNAMIC_DRAW);  // Update all buffer
+
+            // Texture coordinates buffer
+            glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[1]);
+            rlUploadBatchBuffer(buffer, 1, buffer->elementCount*2*4*sizeof(float), RLGL.State.vertexCounter*2*sizeof(float), buffer->texcoords);
+            //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*2*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].texcoords, GL_DYNAMIC_DRAW); // Update all buffer
+
+            // Colors buffer
+            glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[2]);
+            rlUploadBatchBuffer(buffer, 2, buffer->elementCount*4*4*sizeof(unsigned char), RLGL.State.vertexCounter*4*sizeof(unsigned char), buffer->colors);
+            //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*4*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].colors, GL_DYNAMIC_DRAW);    // Update all buffer
+        }
 
         // NOTE: glMapBuffer() causes sync issue.
         // If GPU is working with this buffer, glMapBuffer() will wait(stall) until GPU to finish its job.
@@ -2551,6 +2682,14 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
             glUniformMatrix4fv(RLGL.State.currentShaderLocs[RL_SHADER_LOC_MATRIX_MVP], 1, false, matMVPfloat);
 
             if (RLGL.ExtSupported.vao) glBindVertexArray(batch->vertexBuffer[batch->currentBuffer].vaoId);
+            else if (batch->vertexFormat == RL_BATCH_VERTEX_2D)
+            {
+                // Bind vertex attribs: position, texcoord and color interleaved (shader-location = 0, 1, 3)
+                glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
+                rlSetBatchVertex2DAttribs();
+
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[3]);
+            }
             else
             {
                 // Bind vertex attrib: position (shader-location = 0)
@@ -2628,6 +2767,14 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
 
     // Restore viewport to default measures
     if (eyeCount == 2) rlViewport(0, 0, RLGL.State.framebufferWidth, RLGL.State.framebufferHeight);
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    // Mark when the GPU is done reading this buffer, checked next time it is written
+    if ((rlBatchUploadModeActive == RL_BATCH_UPLOAD_FENCED) && (RLGL.State.vertexCounter > 0))
+    {
+        batch->vertexBuffer[batch->currentBuffer].fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+#endif
     //------------------------------------------------------------------------------------------------------------
 
     // Reset batch buffers
@@ -2707,6 +2854,39 @@ bool rlCheckRenderBatchLimit(int vCount)
     return overflow;
 }
 
+// Set render batch upload path
+// NOTE: Buffers are created for one path, it can not change once rlglInit() loaded the default batch
+void rlSetBatchUploadMode(int mode)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (RLGL.defaultBatch.vertexBuffer != NULL)
+    {
+        TRACELOG(RL_LOG_WARNING, "RLGL: Batch upload mode must be set before rlglInit()");
+        return;
+    }
+#endif
+    rlBatchUploadModeActive = mode;
+}
+
+// Get render batch upload path in use
+int rlGetBatchUploadMode(void)
+{
+    return rlBatchUploadModeActive;
+}
+
+// Set render batch vertex layout
+// NOTE: Only batches loaded afterwards use it, the default batch is loaded by rlglInit()
+void rlSetBatchVertexFormat(int format)
+{
+    rlBatchVertexFormatActive = format;
+}
+
+// Get render batch vertex layout
+int rlGetBatchVertexFormat(void)
+{
+    return rlBatchVertexFormatActive;
+}
+
 // Textures data management
 //-----------------------------------------------------------------------------------------
 // Convert image data to OpenGL texture (returns OpenGL valid Id)
@@ -3224,6 +3404,68 @@ unsigned char *rlReadScreenPixels(int width, int height)
     return imgData;     // NOTE: image data should be freed
 }
 
+// Load pixel buffer for asynchronous screen reads
+// NOTE: Pixel buffer objects only used on OpenGL 3.3, other versions return 0
+unsigned int rlLoadPixelBuffer(int size)
+{
+    unsigned int id = 0;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    glGenBuffers(1, &id);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+
+    return id;
+}
+
+// Unload pixel buffer
+void rlUnloadPixelBuffer(unsigned int id)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    glDeleteBuffers(1, &id);
+#endif
+}
+
+// Start reading screen pixel data into a pixel buffer
+// NOTE: With a pixel pack buffer bound glReadPixels() only queues the copy, map the buffer
+// a frame or more later to get the data without waiting for the GPU
+void rlReadScreenPixelsAsync(unsigned int id, int width, int height)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);    // Offset into the bound buffer
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+}
+
+// Map pixel buffer data for reading
+// NOTE: Data is not flipped like rlReadScreenPixels() does and alpha is kept, the buffer
+// can not be read into again until it is unmapped
+unsigned char *rlMapPixelBuffer(unsigned int id, int size)
+{
+    unsigned char *data = NULL;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+    data = (unsigned char *)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+
+    return data;
+}
+
+// Unmap pixel buffer
+void rlUnmapPixelBuffer(unsigned int id)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+}
+
 // Framebuffer management (fbo)
 //-----------------------------------------------------------------------------------------
 // Load a framebuffer to be used for rendering
@@ -4423,6 +4665,116 @@ static void rlUnloadShaderDefault(void)
     TRACELOG(RL_LOG_INFO, "SHADER: [ID %i] Default shader unloaded successfully", RLGL.State.defaultShaderId);
 }
 
+// Check sync objects and buffer mapping are available for fenced batch uploads
+static bool rlBatchFencesSupported(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    #if defined(__APPLE__)
+    return true;        // Core profile 3.2+ on macOS always has them
+    #else
+    return (glFenceSync != NULL) && (glClientWaitSync != NULL) && (glDeleteSync != NULL) &&
+           (glMapBufferRange != NULL) && (glUnmapBuffer != NULL);
+    #endif
+#else
+    return false;       // OpenGL ES 2.0 has no sync objects
+#endif
+}
+
+// Create the storage of a batch vertex buffer, currently bound to GL_ARRAY_BUFFER
+// NOTE: With fenced uploads and GL_ARB_buffer_storage (OpenGL 4.4) the buffer is mapped once and
+// stays mapped, uploads become a plain memcpy() without any GL call
+static void rlLoadBatchBufferStorage(rlVertexBuffer *buffer, int index, int size, const void *data)
+{
+    buffer->mapped[index] = NULL;
+    if (index == 0) buffer->fence = NULL;
+
+#if defined(GRAPHICS_API_OPENGL_33) && !defined(__APPLE__)
+    if ((rlBatchUploadModeActive == RL_BATCH_UPLOAD_FENCED) && (glBufferStorage != NULL))
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size, data, flags);
+
+        // NOTE: Immutable storage can not be specified again, if mapping fails uploads map it every time instead
+        buffer->mapped[index] = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+        return;
+    }
+#endif
+
+    glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
+}
+
+// Upload vertex data to the start of a batch vertex buffer, currently bound to GL_ARRAY_BUFFER
+// NOTE: fullSize is the size of the whole buffer, size the bytes used by this batch
+static void rlUploadBatchBuffer(rlVertexBuffer *buffer, int index, int fullSize, int size, const void *data)
+{
+    switch (rlBatchUploadModeActive)
+    {
+        case RL_BATCH_UPLOAD_ORPHAN:
+        {
+            // Detach the storage the GPU may still be reading, the driver gives back fresh memory instead of waiting
+            glBufferData(GL_ARRAY_BUFFER, fullSize, NULL, GL_DYNAMIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+        } break;
+#if defined(GRAPHICS_API_OPENGL_33)
+        case RL_BATCH_UPLOAD_FENCED:
+        {
+            // The buffer fence was waited on before, writing without synchronization is safe
+            if (buffer->mapped[index] != NULL) memcpy(buffer->mapped[index], data, size);
+            else
+            {
+                void *target = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+                if (target != NULL)
+                {
+                    memcpy(target, data, size);
+                    glUnmapBuffer(GL_ARRAY_BUFFER);
+                }
+                else glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+            }
+        } break;
+#endif
+        default: glBufferSubData(GL_ARRAY_BUFFER, 0, size, data); break;
+    }
+}
+
+#if defined(GRAPHICS_API_OPENGL_33)
+// Wait for the GPU to finish the draws that last read a batch vertex buffer
+// NOTE: With enough buffers (RL_DEFAULT_BATCH_BUFFERS) the fence is signaled long before and this does not block
+static void rlWaitBatchFence(rlVertexBuffer *buffer)
+{
+    GLsync fence = (GLsync)buffer->fence;
+
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    while (result == GL_TIMEOUT_EXPIRED) result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);   // 1 ms steps
+
+    glDeleteSync(fence);
+    buffer->fence = NULL;
+}
+#endif
+
+// Set the default shader attributes to the interleaved layout of the batch vertex buffer bound to GL_ARRAY_BUFFER
+static void rlSetBatchVertex2DAttribs(void)
+{
+    glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION], 2, GL_FLOAT, 0, sizeof(rlVertex2D), (void *)0);
+    glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION]);
+
+    glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(rlVertex2D), (void *)(2*sizeof(float)));
+    glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
+
+    glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR], 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(rlVertex2D), (void *)(2*sizeof(float) + 2*sizeof(unsigned short)));
+    glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR]);
+}
+
+// Convert a texture coordinate to unsigned normalized short, clamped to [0..1]
+// NOTE: 1/65535 steps keep sub-texel precision up to 8192 pixels textures
+static unsigned short rlPackTexcoord(float t)
+{
+    if (t <= 0.0f) return 0;
+    if (t >= 1.0f) return 65535;
+
+    return (unsigned short)(t*65535.0f + 0.5f);
+}
+
 #if defined(RLGL_SHOW_GL_DETAILS_INFO)
 // Get compressed format official GL identifier name
 static char *rlGetCompressedFormatName(int format)
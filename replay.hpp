@@ -0,0 +1,97 @@
+#ifndef REPLAY
+#define REPLAY
+
+#include <raylib.h>
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+const uint32_t REPLAY_MAGIC(0x504c5248);  // "HRLP"
+const uint32_t REPLAY_VERSION(2);
+
+// Everything the player does during one in-game frame. Deterministic builds
+// run exactly one tick per frame, so a run is replayed by feeding these back
+// frame by frame. Stored field by field, without the struct's padding, so
+// two recordings of the same run are byte-identical.
+struct FrameInput {
+  Vector2 moveDirection;
+  Vector2 aimPosition;
+  uint8_t attack;
+};
+
+struct ReplayHeader {
+  uint32_t magic = REPLAY_MAGIC;
+  uint32_t version = REPLAY_VERSION;
+  uint32_t seed;
+};
+
+// Writes the inputs of a run as it is played. Only the first run after
+// launch is recorded, anything that leaves it (game over, main menu, loading
+// a save) stops the recording.
+struct InputRecorder {
+  std::ofstream file;
+
+  bool open(const char* path, const uint32_t seed) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+    ReplayHeader header;
+    header.seed = seed;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(file);
+  }
+
+  bool recording() const { return file.is_open(); }
+
+  void record(const FrameInput& input) {
+    write(input.moveDirection);
+    write(input.aimPosition);
+    write(input.attack);
+  }
+
+  void close() { file.close(); }
+
+  template <typename T>
+  void write(const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+};
+
+// Feeds a recorded run back, one frame at a time
+struct InputReplay {
+  std::vector<FrameInput> frames;
+  size_t next = 0;
+  uint32_t seed = 0;
+
+  bool load(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    ReplayHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+      return false;
+    }
+    if (header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION) {
+      return false;
+    }
+    seed = header.seed;
+
+    FrameInput input;
+    while (read(file, input.moveDirection) && read(file, input.aimPosition) &&
+           read(file, input.attack)) {
+      frames.push_back(input);
+    }
+    next = 0;
+    return true;
+  }
+
+  bool done() const { return next >= frames.size(); }
+
+  const FrameInput& advance() { return frames[next++]; }
+
+  template <typename T>
+  static bool read(std::ifstream& file, T& value) {
+    return static_cast<bool>(
+      file.read(reinterpret_cast<char*>(&value), sizeof(value))
+    );
+  }
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef ROLLBACK
+#define ROLLBACK
+
+#include <raylib.h>
+
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "components.hpp"
+#include "entt.hpp"
+#include "snapshot.hpp"
+#include "timerwheel.hpp"
+
+const int ROLLBACK_MAX_TICKS(8);  // How far back a resimulation can start
+
+// Player input for one simulation tick
+struct TickInput {
+  Vector2 moveDirection;
+  Vector2 aimPosition;
+};
+
+// Simulation state that lives outside the registry
+struct SimulationState {
+  uint32_t tick;
+  uint64_t rngState;
+  int aiLodCurrentBucket;
+  int aiLodNextBucket;
+  bool canSwing;
+  bool isAttacking;
+};
+
+// Copy of one component storage, kept in packed order so restoring it gives
+// back the same iteration order. The vectors keep their capacity between
+// saves, so after warm-up a save is a straight copy.
+template <typename Type>
+struct StorageCopy {
+  static_assert(std::is_trivially_copyable_v<Type>, "Copied as plain data");
+
+  std::vector<entt::entity> entities;
+  std::vector<Type> components;
+
+  void reserve(const size_t capacity) {
+    entities.reserve(capacity);
+    components.reserve(capacity);
+  }
+
+  void save(entt::registry& registry) {
+    auto& storage = registry.storage<Type>();
+    const entt::sparse_set& base = storage;
+    entities.assign(base.rbegin(), base.rend());
+    components.assign(storage.rbegin(), storage.rend());
+  }
+
+  // Storage must be empty
+  void restore(entt::registry& registry) {
+    registry.storage<Type>().insert(
+      entities.begin(), entities.end(), components.begin()
+    );
+  }
+};
+
+// Full in-memory copy of the simulation. Unlike a save file the timer wheel
+// is copied as is rather than rebuilt, so timers sharing a tick still expire
+// in the same order after a restore.
+template <typename... Type>
+struct WorldSnapshotOf {
+  std::vector<entt::entity> entityPool;
+  entt::entity released;
+  std::tuple<StorageCopy<Type>...> storages;
+  TimerWheel timerWheel;
+  SimulationState state;
+
+  // Room for a world of this many entities and pending timers, so saving it
+  // never reallocates
+  void reserve(const size_t entities, const size_t timers) {
+    entityPool.reserve(entities);
+    std::apply(
+      [entities](auto&... storage) { (storage.reserve(entities), ...); },
+      storages
+    );
+    timerWheel.reserve(timers);
+  }
+
+  void save(
+    entt::registry& registry, const TimerWheel& _timerWheel,
+    const SimulationState& _state
+  ) {
+    entityPool.assign(registry.data(), registry.data() + registry.size());
+    released = registry.released();
+    std::apply(
+      [&registry](auto&... storage) { (storage.save(registry), ...); },
+      storages
+    );
+    timerWheel = _timerWheel;
+    state = _state;
+  }
+
+  // Puts the registry and wheel back, the caller restores state
+  void restore(entt::registry& registry, TimerWheel& _timerWheel) {
+    registry.clear();
+    registry.assign(entityPool.begin(), entityPool.end(), released);
+    std::apply(
+      [&registry](auto&... storage) { (storage.restore(registry), ...); },
+      storages
+    );
+    _timerWheel = timerWheel;
+  }
+};
+
+using WorldSnapshot = WorldSnapshotOf<SNAPSHOT_COMPONENTS>;
+
+// The last ROLLBACK_MAX_TICKS world states, each saved right before a tick
+// along with the input that tick was simulated with
+struct RollbackRing {
+  WorldSnapshot snapshots[ROLLBACK_MAX_TICKS];
+  TickInput inputs[ROLLBACK_MAX_TICKS];
+  uint32_t ticks[ROLLBACK_MAX_TICKS];
+  bool used[ROLLBACK_MAX_TICKS] = {};
+
+  void reserve(const size_t entities, const size_t timers) {
+    for (int i = 0; i < ROLLBACK_MAX_TICKS; i++) {
+      snapshots[i].reserve(entities, timers);
+    }
+  }
+
+  void record(
+    entt::registry& registry, const TimerWheel& timerWheel,
+    const SimulationState& state, const TickInput& input
+  ) {
+    int slot = state.tick % ROLLBACK_MAX_TICKS;
+    snapshots[slot].save(registry, timerWheel, state);
+    inputs[slot] = input;
+    ticks[slot] = state.tick;
+    used[slot] = true;
+  }
+
+  bool has(const uint32_t tick) const {
+    int slot = tick % ROLLBACK_MAX_TICKS;
+    return used[slot] && ticks[slot] == tick;
+  }
+
+  WorldSnapshot& snapshotAt(const uint32_t tick) {
+    return snapshots[tick % ROLLBACK_MAX_TICKS];
+  }
+
+  const TickInput& inputAt(const uint32_t tick) const {
+    return inputs[tick % ROLLBACK_MAX_TICKS];
+  }
+
+  void clear() {
+    for (int i = 0; i < ROLLBACK_MAX_TICKS; i++) used[i] = false;
+  }
+};
+
+#endif
@@ -0,0 +1,304 @@
+#ifndef SNAPSHOT
+#define SNAPSHOT
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ailod.hpp"
+#include "components.hpp"
+#include "entt.hpp"
+#include "helper.hpp"
+#include "stats.hpp"
+#include "timerwheel.hpp"
+
+const uint32_t SNAPSHOT_MAGIC(0x4c534b48);  // "HKSL"
+const uint32_t SNAPSHOT_VERSION(4);
+const size_t SNAPSHOT_BUFFER_SIZE(64 * 1024);
+
+// Everything outside the registry that a run needs to resume
+struct SnapshotHeader {
+  uint32_t magic = SNAPSHOT_MAGIC;
+  uint32_t version = SNAPSHOT_VERSION;
+  uint64_t payloadHash = 0;  // Of everything after the header
+  uint64_t payloadSize = 0;
+
+  uint64_t rngState;
+  uint32_t tick;
+  int32_t score;
+  int32_t requiredEnemyCount;
+  int32_t timesEnemiesSpawned;
+  int32_t timesEnemiesSpedUp;
+  float startWaitTime;
+  int32_t aiLodCurrentBucket;
+  int32_t aiLodNextBucket;
+  entt::entity playerEntity;
+  entt::entity weaponEntity;
+  entt::entity weaponAnimationEntity;
+  uint8_t gameHasJustStarted;
+  uint8_t canSwing;
+  uint8_t isAttacking;
+  int32_t mobsSpawned[MOB_TYPE_COUNT];  // RegistryStats, live is recounted
+  int32_t mobsDestroyed[MOB_TYPE_COUNT];
+};
+
+// Hash 8 bytes at a time, the payload is too large to hash byte by byte
+// within the save budget
+static uint64_t hashWords(uint64_t hash, const char* data, const size_t size) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * 1099511628211ull;
+  }
+  for (; i < size; i++) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+  }
+  return hash;
+}
+
+// Writes raw bytes through a fixed buffer, flushing to the stream whenever
+// it fills up. Chunks are always a full
+// buffer, so hashing them one at a time matches hashing the whole payload.
+struct SnapshotWriter {
+  std::ostream& out;
+  std::vector<char> buffer;
+  size_t used = 0;
+  uint64_t hash = 14695981039346656037ull;
+  uint64_t size = 0;
+
+  SnapshotWriter(std::ostream& _out) : out(_out), buffer(SNAPSHOT_BUFFER_SIZE) {}
+
+  void write(const void* data, size_t count) {
+    const char* bytes = static_cast<const char*>(data);
+    size += count;
+    if (used + count < buffer.size()) {  // Common case, a field at a time
+      memcpy(buffer.data() + used, bytes, count);
+      used += count;
+      return;
+    }
+    while (count > 0) {
+      size_t chunk = std::min(count, buffer.size() - used);
+      memcpy(buffer.data() + used, bytes, chunk);
+      used += chunk;
+      bytes += chunk;
+      count -= chunk;
+      if (used == buffer.size()) flush();
+    }
+  }
+
+  void flush() {
+    hash = hashWords(hash, buffer.data(), used);
+    out.write(buffer.data(), used);
+    used = 0;
+  }
+
+  template <typename T>
+  void operator()(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Needs a custom overload");
+    write(&value, sizeof(T));
+  }
+};
+
+// Reads back what SnapshotWriter wrote, from a buffer already in memory
+struct SnapshotReader {
+  const char* data;
+  size_t size;
+  size_t offset = 0;
+
+  void read(void* destination, const size_t count) {
+    if (offset + count > size) {  // Only possible with a corrupt payload
+      memset(destination, 0, count);
+      offset = size;
+      return;
+    }
+    memcpy(destination, data + offset, count);
+    offset += count;
+  }
+
+  template <typename T>
+  void operator()(T& value) {
+    read(&value, sizeof(T));
+  }
+
+  // Moves past count bytes and returns where they start, or nullptr if the
+  // payload is too short, only possible when corrupt
+  const char* skip(const size_t count) {
+    if (count > size - offset) {
+      offset = size;
+      return nullptr;
+    }
+    const char* start = data + offset;
+    offset += count;
+    return start;
+  }
+};
+
+using SnapshotCount = entt::entt_traits<entt::entity>::entity_type;
+
+// Output archive for entt::snapshot. entt hands over a storage's length and
+// then one entity and component at a time. They are gathered here and the
+// storage is written as two blocks, its entities followed by its
+// components, like StorageCopy keeps them in rollback.hpp.
+struct SnapshotOutputArchive {
+  SnapshotWriter& writer;
+  std::vector<entt::entity> runEntities;
+  std::vector<char> runComponents;
+  SnapshotCount runLength = 0;
+  SnapshotCount runWritten = 0;
+
+  // Lengths come before the entity list and before every storage
+  void operator()(const SnapshotCount length) {
+    writer(length);
+    runLength = length;
+    runWritten = 0;
+  }
+
+  // The entity list is written as it comes, it is a single array already
+  void operator()(const entt::entity e) { writer(e); }
+
+  template <typename T>
+  void operator()(const entt::entity e, const T& component) {
+    static_assert(std::is_trivially_copyable_v<T>, "Saved as plain data");
+    if (runWritten == 0) {
+      runEntities.resize(runLength);
+      runComponents.resize(runLength * sizeof(T));
+    }
+    runEntities[runWritten] = e;
+    memcpy(&runComponents[runWritten * sizeof(T)], &component, sizeof(T));
+    if (++runWritten == runLength) {
+      writer.write(runEntities.data(), runLength * sizeof(entt::entity));
+      writer.write(runComponents.data(), runLength * sizeof(T));
+    }
+  }
+};
+
+// Input archive for entt::snapshot_loader, reads the layout written by
+// SnapshotOutputArchive. Each storage is reserved from its length before
+// the loader emplaces into it one component at a time.
+struct SnapshotInputArchive {
+  SnapshotReader& reader;
+  entt::registry& registry;
+  SnapshotCount runLength = 0;
+  SnapshotCount runRead = 0;
+  const char* runEntities = nullptr;
+  const char* runComponents = nullptr;
+
+  void operator()(SnapshotCount& length) {
+    reader(length);
+    runLength = length;
+    runRead = 0;
+  }
+
+  void operator()(entt::entity& e) { reader(e); }
+
+  template <typename T>
+  void operator()(entt::entity& e, T& component) {
+    if (runRead == 0) {
+      runEntities = reader.skip(size_t(runLength) * sizeof(entt::entity));
+      runComponents = reader.skip(size_t(runLength) * sizeof(T));
+      registry.storage<T>().reserve(runLength);
+    }
+    if (runEntities == nullptr || runComponents == nullptr) {
+      e = entt::entity(runRead);  // Zeroed data, distinct so emplace works
+      component = T{};
+    } else {
+      memcpy(&e, runEntities + runRead * sizeof(entt::entity), sizeof(e));
+      memcpy(&component, runComponents + runRead * sizeof(T), sizeof(T));
+    }
+    runRead++;
+  }
+};
+
+// Components saved with a run, in file order
+#define SNAPSHOT_COMPONENTS                                                   \
+  CharacterComponent, MobComponent, SpawnInfoComponent, TimerComponent,       \
+    StraightMovementComponent, ScoreOnKillComponent, PlayerComponent,         \
+    meleeWeaponComponent, AILodComponent
+
+static bool saveSnapshot(
+  const char* path, const entt::registry& registry, SnapshotHeader header
+) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) return false;
+
+  // Reserve the header's space, it is rewritten once the payload is hashed
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  SnapshotWriter writer(file);
+  SnapshotOutputArchive archive{writer};
+  entt::snapshot{registry}.entities(archive).component<SNAPSHOT_COMPONENTS>(
+    archive
+  );
+  writer.flush();
+
+  header.payloadHash = writer.hash;
+  header.payloadSize = writer.size;
+  file.seekp(0);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  return static_cast<bool>(file);
+}
+
+// Replaces the registry with the snapshot's. The file is read and verified
+// in full first, so a bad file leaves the registry untouched. No signals
+// fire, but listeners such as RegistryStats have to connect again after a
+// successful load since the storages they were connected to are gone.
+static bool loadSnapshot(
+  const char* path, entt::registry& registry, SnapshotHeader& header
+) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return false;
+
+  SnapshotHeader fileHeader;
+  if (!file.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader))) {
+    return false;
+  }
+  if (fileHeader.magic != SNAPSHOT_MAGIC ||
+      fileHeader.version != SNAPSHOT_VERSION) {
+    return false;
+  }
+
+  std::vector<char> payload(fileHeader.payloadSize);
+  if (!file.read(payload.data(), payload.size())) return false;
+  if (hashWords(14695981039346656037ull, payload.data(), payload.size()) !=
+      fileHeader.payloadHash) {
+    return false;
+  }
+
+  // Filled into a new registry that then replaces the old one. Clearing the
+  // old one would emit a signal and a group update per component, which
+  // took longer than the rest of the load. The mob group is made once the
+  // storages are full, lining them up in a single pass.
+  entt::registry loaded;
+  SnapshotReader reader{payload.data(), payload.size()};
+  SnapshotInputArchive archive{reader, loaded};
+  entt::snapshot_loader{loaded}
+    .entities(archive)
+    .component<SNAPSHOT_COMPONENTS>(archive);
+  mobGroup(loaded);
+  registry = std::move(loaded);
+
+  header = fileHeader;
+  return true;
+}
+
+// The wheel itself is not saved, every pending timer is put back from the
+// dueTick stored in its TimerComponent
+static void rebuildTimerWheel(
+  entt::registry& registry, TimerWheel& timerWheel, const uint32_t tick
+) {
+  timerWheel.clear();
+  timerWheel.currentTick = tick;
+  for (auto e : registry.view<TimerComponent>()) {
+    TimerComponent& tc = registry.get<TimerComponent>(e);
+    if (tc.dueTick > tick) {
+      timerWheel.schedule(e, tc.dueTick);
+    }
+  }
+}
+
+#endif
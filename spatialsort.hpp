@@ -0,0 +1,114 @@
+#ifndef SPATIAL_SORT
+#define SPATIAL_SORT
+
+#include <raylib.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "ailod.hpp"
+#include "components.hpp"
+#include "entt.hpp"
+
+const float SPATIAL_SORT_CELL_SIZE(60.0f);  // Same as the collision grid
+const uint32_t SPATIAL_SORT_CHECK_INTERVAL(15);  // Ticks between disorder checks
+const uint32_t SPATIAL_SORT_INTERVAL(120);  // Sort at least this often
+const float SPATIAL_SORT_MAX_DISORDER(0.1f);  // Sort early above this
+const int SPATIAL_SORT_MIN_COUNT(64);  // Below this everything fits in cache
+
+// Spread the low 16 bits of v out to the even bits
+static uint32_t mortonSpread(uint32_t v) {
+  v &= 0x0000ffff;
+  v = (v | (v << 8)) & 0x00ff00ff;
+  v = (v | (v << 4)) & 0x0f0f0f0f;
+  v = (v | (v << 2)) & 0x33333333;
+  v = (v | (v << 1)) & 0x55555555;
+  return v;
+}
+
+// Z-order key of the grid cell a position falls in. Cells close on screen
+// get keys close together, so sorting by it keeps neighbours close in memory.
+static uint32_t mortonKey(const Vector2 position) {
+  float x = position.x / SPATIAL_SORT_CELL_SIZE;
+  float y = position.y / SPATIAL_SORT_CELL_SIZE;
+  uint32_t cellX = x <= 0.0f ? 0 : x >= 65535.0f ? 65535 : uint32_t(x);
+  uint32_t cellY = y <= 0.0f ? 0 : y >= 65535.0f ? 65535 : uint32_t(y);
+  return mortonSpread(cellX) | (mortonSpread(cellY) << 1);
+}
+
+// Keeps the kinematics storages in Z-order so the physics tick walks
+// neighbouring entities one after another. Mobs are sorted through their
+// owning group by the key of their position, which keeps the group's
+// storages lined up, and the other per-tick storages follow its order.
+// Whether a tick sorts only depends on the tick number and the world, so
+// replays and rollback sort on the same ticks as the original run.
+struct SpatialSorter {
+  std::vector<uint32_t> keys;  // Indexed by entity, rebuilt on every sort
+  float lastDisorder = 0.0f;
+  int sorts = 0;
+
+  // Call between ticks, never while iterating over the sorted storages
+  void update(entt::registry& registry, const uint32_t tick) {
+    if (tick % SPATIAL_SORT_CHECK_INTERVAL != 0) return;
+    auto& characters = registry.storage<CharacterComponent>();
+    if (characters.size() < SPATIAL_SORT_MIN_COUNT) return;
+
+    lastDisorder = disorder(characters);
+    if (lastDisorder > SPATIAL_SORT_MAX_DISORDER ||
+        tick % SPATIAL_SORT_INTERVAL == 0) {
+      sort(registry);
+    }
+  }
+
+  // Share of neighbouring characters, in iteration order, that are out of
+  // Z-order. 0 right after a sort, about 0.5 for creation order.
+  template <typename Storage>
+  float disorder(const Storage& characters) const {
+    int descents = 0;
+    uint32_t previous = 0;
+    for (auto it = characters.begin(); it != characters.end(); ++it) {
+      uint32_t key = mortonKey(it->position);
+      if (key < previous) descents++;
+      previous = key;
+    }
+    return float(descents) / float(characters.size() - 1);
+  }
+
+  void reserve(const size_t entities) { keys.reserve(entities); }
+
+  void sort(entt::registry& registry) {
+    keys.resize(registry.size());
+    for (auto [e, cc] : registry.storage<CharacterComponent>().each()) {
+      keys[entt::to_entity(e)] = mortonKey(cc.position);
+    }
+
+    // Owned storages can only be sorted through their group
+    auto mobs = mobGroup(registry);
+    // Ties broken on the entity so the order is total. std::sort is not
+    // stable, and iteration order feeds collisions and random draws.
+    auto compare = [this](const entt::entity a, const entt::entity b) {
+      uint32_t keyA = keys[entt::to_entity(a)];
+      uint32_t keyB = keys[entt::to_entity(b)];
+      if (keyA != keyB) return keyA < keyB;
+      return entt::to_integral(a) < entt::to_integral(b);
+    };
+    // Mostly in order already, unless a wave was just spawned
+    if (lastDisorder < SPATIAL_SORT_MAX_DISORDER) {
+      mobs.sort(compare, entt::insertion_sort{});
+    } else {
+      mobs.sort(compare);
+    }
+    follow<AILodComponent>(registry);
+    follow<StraightMovementComponent>(registry);
+    sorts++;
+  }
+
+  template <typename Type>
+  void follow(entt::registry& registry) {
+    if (!registry.owned<Type>()) {
+      registry.sort<Type, CharacterComponent>();
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef SPAWN_BATCH
+#define SPAWN_BATCH
+
+#include "ailod.hpp"
+#include "arena.hpp"
+#include "components.hpp"
+#include "entt.hpp"
+#include "timerwheel.hpp"
+
+const int WAVE_BULLETS_PER_MOB(1);  // Bullets in flight to plan for, per mob
+
+// Reserve entity and component storage so that a wave of waveSize mobs, and
+// the bullets they fire, fit without reallocating in the middle of a tick.
+// Sparse pages are not covered, entt only grows those every 4096 entities.
+static void reserveForWave(entt::registry& registry, const size_t waveSize) {
+  size_t mobs = registry.storage<MobComponent>().size() + waveSize;
+  size_t bullets = waveSize * WAVE_BULLETS_PER_MOB;
+
+  registry.reserve(registry.size() + waveSize + bullets);
+  registry.storage<CharacterComponent>().reserve(
+    registry.storage<CharacterComponent>().size() + waveSize + bullets
+  );
+  registry.storage<MobComponent>().reserve(mobs + bullets);
+  registry.storage<SpawnInfoComponent>().reserve(mobs + bullets);
+  registry.storage<ScoreOnKillComponent>().reserve(mobs);
+  registry.storage<AILodComponent>().reserve(mobs);
+  registry.storage<TimerComponent>().reserve(
+    registry.storage<TimerComponent>().size() + waveSize
+  );
+  registry.storage<StraightMovementComponent>().reserve(
+    registry.storage<StraightMovementComponent>().size() + bullets
+  );
+}
+
+// A wave of mobs built up front and then added to the registry with range
+// create/insert, so the whole wave is one contiguous fill per storage. Only
+// lives while the wave spawns, so it is built in the frame arena.
+struct SpawnBatch {
+  ArenaVector<entt::entity> entities;
+  ArenaVector<CharacterComponent> characters;
+  ArenaVector<MobComponent> mobs;
+  ArenaVector<SpawnInfoComponent> spawns;
+  ArenaVector<AILodComponent> lods;
+
+  // Only ranged mobs have timers, indices point into the vectors above
+  ArenaVector<size_t> timedIndices;
+  ArenaVector<entt::entity> timedEntities;
+  ArenaVector<TimerComponent> timers;
+
+  SpawnBatch(FrameArena& arena)
+      : entities(&arena),
+        characters(&arena),
+        mobs(&arena),
+        spawns(&arena),
+        lods(&arena),
+        timedIndices(&arena),
+        timedEntities(&arena),
+        timers(&arena) {}
+
+  void reserve(const size_t count) {
+    entities.reserve(count);
+    characters.reserve(count);
+    mobs.reserve(count);
+    spawns.reserve(count);
+    lods.reserve(count);
+    timedIndices.reserve(count);
+    timedEntities.reserve(count);
+    timers.reserve(count);
+  }
+
+  size_t size() const { return characters.size(); }
+
+  // Create the batch's entities, insert their components and schedule timers
+  void commit(entt::registry& registry, TimerWheel& timerWheel) {
+    entities.resize(size());
+    registry.create(entities.begin(), entities.end());
+
+    registry.insert<CharacterComponent>(
+      entities.begin(), entities.end(), characters.begin()
+    );
+    registry.insert<MobComponent>(entities.begin(), entities.end(), mobs.begin());
+    registry.insert<SpawnInfoComponent>(
+      entities.begin(), entities.end(), spawns.begin()
+    );
+    registry.insert<ScoreOnKillComponent>(entities.begin(), entities.end());
+    registry.insert<AILodComponent>(entities.begin(), entities.end(), lods.begin());
+
+    timedEntities.resize(timedIndices.size());
+    for (size_t i = 0; i < timedIndices.size(); i++) {
+      timedEntities[i] = entities[timedIndices[i]];
+    }
+    registry.insert<TimerComponent>(
+      timedEntities.begin(), timedEntities.end(), timers.begin()
+    );
+    for (size_t i = 0; i < timedEntities.size(); i++) {
+      timerWheel.schedule(timedEntities[i], timers[i].dueTick);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef SPRITE_BATCH
+#define SPRITE_BATCH
+
+#include <raylib.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "spritequad.hpp"
+
+// Draw order, lower layers are drawn first
+enum SpriteLayer : uint8_t {
+  LAYER_MOBS,
+  LAYER_BULLETS,
+  LAYER_PLAYER,
+};
+
+struct SpriteCommand {
+  uint32_t key;  // Layer in the top byte, texture id below it
+  bool circle;  // Drawn as a triangle fan, no circle source was set
+  Texture2D texture;
+  Rectangle source;  // For a circle, x and y are the centre, width the radius
+  Rectangle dest;
+  Vector2 origin;
+  Vector2 facing;  // Unit vector the sprite's x axis turns to
+  Color tint;
+};
+
+// Collects a frame's entity sprites and draws them grouped by layer and
+// texture. rlgl starts a new draw call on every texture change, so drawing
+// in storage order, where melee, ranged and bullets interleave, splits the
+// batch on almost every entity. Commands are radix sorted by key, which is
+// stable, so sprites sharing a texture keep their submission order. Sprites
+// are turned by facing vectors rather than angles, and their corners built
+// in one SIMD pass over the sorted commands.
+struct SpriteBatch {
+  std::vector<SpriteCommand> commands;
+  std::vector<SpriteCommand> sorted;  // Radix sort scratch
+  SpriteQuadBatch quads;
+  // A white disc circles are drawn from as one tinted quad each. Unset,
+  // they fall back to DrawCircleV, which builds 18 quads per circle.
+  Texture2D circleTexture = {};
+  Rectangle circleSource = {};
+
+  // Texture runs in the last flush, each one a draw call or more
+  size_t lastSprites = 0;
+  size_t lastRuns = 0;
+  size_t lastUnsortedRuns = 0;  // What drawing in submission order would take
+
+  void reserve(const size_t count) {
+    commands.reserve(count);
+    sorted.reserve(count);
+    quads.reserve(count);
+  }
+
+  void draw(
+    const SpriteLayer layer, const Texture2D texture, const Rectangle source,
+    const Rectangle dest, const Vector2 origin, const Vector2 facing,
+    const Color tint
+  ) {
+    commands.push_back(
+      {key(layer, texture.id), false, texture, source, dest, origin, facing,
+       tint}
+    );
+  }
+
+  void drawCircle(
+    const SpriteLayer layer, const Vector2 center, const float radius,
+    const Color color
+  ) {
+    if (circleTexture.id != 0) {
+      draw(
+        layer, circleTexture, circleSource,
+        {center.x, center.y, radius * 2.0f, radius * 2.0f}, {radius, radius},
+        {1.0f, 0.0f}, color
+      );
+      return;
+    }
+    commands.push_back(
+      {key(layer, 0), true, {}, {center.x, center.y, radius, 0.0f}, {}, {},
+       {1.0f, 0.0f}, color}
+    );
+  }
+
+  // Draws everything collected since the last flush
+  void flush() {
+    lastSprites = commands.size();
+    lastUnsortedRuns = countRuns(commands);
+    radixSort();
+    lastRuns = countRuns(commands);
+
+    quads.clear();
+    for (size_t i = 0; i < commands.size(); i++) {
+      const SpriteCommand& c = commands[i];
+      if (!c.circle) quads.add(c.dest, c.origin, c.facing);
+    }
+    quads.transform();
+
+    size_t quad = 0;
+    for (size_t i = 0; i < commands.size(); i++) {
+      const SpriteCommand& c = commands[i];
+      if (c.circle) {
+        DrawCircleV({c.source.x, c.source.y}, c.source.width, c.tint);
+      } else {
+        emitSpriteQuad(c.texture, c.source, quads.corners(quad++), c.tint);
+      }
+    }
+    commands.clear();
+  }
+
+  static uint32_t key(const SpriteLayer layer, const unsigned int textureId) {
+    return (uint32_t(layer) << 24) | (textureId & 0x00ffffff);
+  }
+
+  static size_t countRuns(const std::vector<SpriteCommand>& list) {
+    size_t runs = 0;
+    for (size_t i = 0; i < list.size(); i++) {
+      if (i == 0 || list[i].texture.id != list[i - 1].texture.id) runs++;
+    }
+    return runs;
+  }
+
+  // LSD radix sort on the key, a byte per pass. Passes where every key has
+  // the same byte are skipped, which with a handful of textures and layers
+  // leaves two.
+  void radixSort() {
+    if (commands.empty()) return;
+    sorted.resize(commands.size());
+    for (int shift = 0; shift < 32; shift += 8) {
+      size_t counts[256] = {};
+      for (size_t i = 0; i < commands.size(); i++) {
+        counts[(commands[i].key >> shift) & 0xff]++;
+      }
+      if (counts[(commands[0].key >> shift) & 0xff] == commands.size()) {
+        continue;
+      }
+
+      size_t offsets[256];
+      size_t offset = 0;
+      for (int digit = 0; digit < 256; digit++) {
+        offsets[digit] = offset;
+        offset += counts[digit];
+      }
+      for (size_t i = 0; i < commands.size(); i++) {
+        sorted[offsets[(commands[i].key >> shift) & 0xff]++] = commands[i];
+      }
+      commands.swap(sorted);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef SPRITE_QUAD
+#define SPRITE_QUAD
+
+#include <raylib.h>
+#include <rlgl.h>
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define SPRITE_QUAD_SSE
+#include <xmmintrin.h>
+#endif
+
+// Unit vector from one point towards another, what findRotationAngle's angle
+// would be as {cos, sin}. Facing right when the points coincide, as atan2
+// gives 0 there.
+static Vector2 facingVector(const Vector2 from, const Vector2 to) {
+  float dx = to.x - from.x;
+  float dy = to.y - from.y;
+  float length = sqrtf(dx * dx + dy * dy);
+  if (length == 0.0f) return {1.0f, 0.0f};
+  return {dx / length, dy / length};
+}
+
+// Corners in the order rlgl takes a quad, as DrawTexturePro builds them
+struct SpriteQuad {
+  Vector2 topLeft;
+  Vector2 bottomLeft;
+  Vector2 bottomRight;
+  Vector2 topRight;
+};
+
+// Adds a quad to the rlgl batch with the texture coordinates DrawTexturePro
+// gives a source rectangle, flips included
+static void emitSpriteQuad(
+  const Texture2D texture, Rectangle source, const SpriteQuad& quad,
+  const Color tint
+) {
+  if (texture.id == 0) return;
+  bool flipX = false;
+  if (source.width < 0) {
+    flipX = true;
+    source.width *= -1;
+  }
+  if (source.height < 0) source.y -= source.height;
+
+  float left = source.x / texture.width;
+  float right = (source.x + source.width) / texture.width;
+  float top = source.y / texture.height;
+  float bottom = (source.y + source.height) / texture.height;
+  if (flipX) std::swap(left, right);
+
+  rlCheckRenderBatchLimit(4);
+  rlSetTexture(texture.id);
+  rlBegin(RL_QUADS);
+  rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+  rlTexCoord2f(left, top);
+  rlVertex2f(quad.topLeft.x, quad.topLeft.y);
+  rlTexCoord2f(left, bottom);
+  rlVertex2f(quad.bottomLeft.x, quad.bottomLeft.y);
+  rlTexCoord2f(right, bottom);
+  rlVertex2f(quad.bottomRight.x, quad.bottomRight.y);
+  rlTexCoord2f(right, top);
+  rlVertex2f(quad.topRight.x, quad.topRight.y);
+  rlEnd();
+  rlSetTexture(0);
+}
+
+// DrawTexturePro's corners for many sprites, each rotated to a unit facing
+// vector rather than an angle, so without its sinf and cosf. A field per
+// array so four sprites are built at once with SSE. The scalar loop takes the rest, and
+// everything without SSE, in the same order of operations, so both give the
+// same corners.
+struct SpriteQuadBatch {
+  std::vector<float> x, y;
+  std::vector<float> left, top, right, bottom;  // Corner offsets from x, y
+  std::vector<float> cosine, sine;
+  // Indexed by corner, in SpriteQuad order
+  std::vector<float> cornerX[4];
+  std::vector<float> cornerY[4];
+
+  size_t size() const { return x.size(); }
+
+  void reserve(const size_t count) {
+    std::vector<float>* fields[] = {&x,     &y,      &left,   &top,
+                                    &right, &bottom, &cosine, &sine};
+    for (std::vector<float>* field : fields) field->reserve(count);
+    for (int k = 0; k < 4; k++) {
+      cornerX[k].reserve(count);
+      cornerY[k].reserve(count);
+    }
+  }
+
+  void clear() {
+    std::vector<float>* fields[] = {&x,     &y,      &left,   &top,
+                                    &right, &bottom, &cosine, &sine};
+    for (std::vector<float>* field : fields) field->clear();
+  }
+
+  void add(const Rectangle dest, const Vector2 origin, const Vector2 facing) {
+    x.push_back(dest.x);
+    y.push_back(dest.y);
+    left.push_back(-origin.x);
+    top.push_back(-origin.y);
+    right.push_back(dest.width - origin.x);
+    bottom.push_back(dest.height - origin.y);
+    cosine.push_back(facing.x);
+    sine.push_back(facing.y);
+  }
+
+  // Builds the corners of every sprite added since the last clear
+  void transform() {
+    size_t count = size();
+    for (int k = 0; k < 4; k++) {
+      cornerX[k].resize(count);
+      cornerY[k].resize(count);
+    }
+
+    size_t i = 0;
+#ifdef SPRITE_QUAD_SSE
+    for (; i + 4 <= count; i += 4) {
+      __m128 px = _mm_loadu_ps(&x[i]);
+      __m128 py = _mm_loadu_ps(&y[i]);
+      __m128 c = _mm_loadu_ps(&cosine[i]);
+      __m128 s = _mm_loadu_ps(&sine[i]);
+      __m128 l = _mm_loadu_ps(&left[i]);
+      __m128 t = _mm_loadu_ps(&top[i]);
+      __m128 r = _mm_loadu_ps(&right[i]);
+      __m128 b = _mm_loadu_ps(&bottom[i]);
+
+      __m128 lc = _mm_mul_ps(l, c), ls = _mm_mul_ps(l, s);
+      __m128 rc = _mm_mul_ps(r, c), rs = _mm_mul_ps(r, s);
+      __m128 tc = _mm_mul_ps(t, c), ts = _mm_mul_ps(t, s);
+      __m128 bc = _mm_mul_ps(b, c), bs = _mm_mul_ps(b, s);
+
+      _mm_storeu_ps(&cornerX[0][i], _mm_sub_ps(_mm_add_ps(px, lc), ts));
+      _mm_storeu_ps(&cornerY[0][i], _mm_add_ps(_mm_add_ps(py, ls), tc));
+      _mm_storeu_ps(&cornerX[1][i], _mm_sub_ps(_mm_add_ps(px, lc), bs));
+      _mm_storeu_ps(&cornerY[1][i], _mm_add_ps(_mm_add_ps(py, ls), bc));
+      _mm_storeu_ps(&cornerX[2][i], _mm_sub_ps(_mm_add_ps(px, rc), bs));
+      _mm_storeu_ps(&cornerY[2][i], _mm_add_ps(_mm_add_ps(py, rs), bc));
+      _mm_storeu_ps(&cornerX[3][i], _mm_sub_ps(_mm_add_ps(px, rc), ts));
+      _mm_storeu_ps(&cornerY[3][i], _mm_add_ps(_mm_add_ps(py, rs), tc));
+    }
+#endif
+    for (; i < count; i++) {
+      float c = cosine[i];
+      float s = sine[i];
+      cornerX[0][i] = x[i] + left[i] * c - top[i] * s;
+      cornerY[0][i] = y[i] + left[i] * s + top[i] * c;
+      cornerX[1][i] = x[i] + left[i] * c - bottom[i] * s;
+      cornerY[1][i] = y[i] + left[i] * s + bottom[i] * c;
+      cornerX[2][i] = x[i] + right[i] * c - bottom[i] * s;
+      cornerY[2][i] = y[i] + right[i] * s + bottom[i] * c;
+      cornerX[3][i] = x[i] + right[i] * c - top[i] * s;
+      cornerY[3][i] = y[i] + right[i] * s + top[i] * c;
+    }
+  }
+
+  SpriteQuad corners(const size_t i) const {
+    return {
+      {cornerX[0][i], cornerY[0][i]},
+      {cornerX[1][i], cornerY[1][i]},
+      {cornerX[2][i], cornerY[2][i]},
+      {cornerX[3][i], cornerY[3][i]}};
+  }
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef STATS
+#define STATS
+
+#include "components.hpp"
+#include "entt.hpp"
+
+const int MOB_TYPE_COUNT(4);
+
+// Registry-wide aggregate counters, kept up to date by the registry's
+// construction/destruction signals so reading them never needs a scan.
+// MobComponent has to be emplaced with its type already set, and a mob that
+// changes type must go through retype() to keep the counts right.
+struct RegistryStats {
+  int live[MOB_TYPE_COUNT] = {};
+  int spawned[MOB_TYPE_COUNT] = {};
+  int destroyed[MOB_TYPE_COUNT] = {};
+
+  void connect(entt::registry& registry) {
+    registry.on_construct<MobComponent>()
+      .connect<&RegistryStats::onMobConstruct>(*this);
+    registry.on_destroy<MobComponent>()
+      .connect<&RegistryStats::onMobDestroy>(*this);
+  }
+
+  void disconnect(entt::registry& registry) {
+    registry.on_construct<MobComponent>().disconnect(*this);
+    registry.on_destroy<MobComponent>().disconnect(*this);
+  }
+
+  void onMobConstruct(entt::registry& registry, entt::entity e) {
+    MobType type = registry.get<MobComponent>(e).type;
+    live[type]++;
+    spawned[type]++;
+  }
+
+  void onMobDestroy(entt::registry& registry, entt::entity e) {
+    MobType type = registry.get<MobComponent>(e).type;
+    live[type]--;
+    destroyed[type]++;
+  }
+
+  // Live counts from scratch, for a registry that was filled without the
+  // signals connected
+  void recount(entt::registry& registry) {
+    for (int i = 0; i < MOB_TYPE_COUNT; i++) live[i] = 0;
+    for (auto [e, mc] : registry.storage<MobComponent>().each()) {
+      live[mc.type]++;
+    }
+  }
+
+  void retype(MobComponent& mc, const MobType type) {
+    live[mc.type]--;
+    live[type]++;
+    mc.type = type;
+  }
+
+  int liveEnemies() const { return live[MELEE] + live[RANGE]; }
+
+  int bulletsInFlight() const { return live[BULLET] + live[FRIENDLY_BULLET]; }
+
+  int enemiesSpawned() const { return spawned[MELEE] + spawned[RANGE]; }
+
+  int enemiesDestroyed() const { return destroyed[MELEE] + destroyed[RANGE]; }
+};
+
+#endif
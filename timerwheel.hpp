@@ -0,0 +1,142 @@
+#ifndef TIMER_WHEEL
+#define TIMER_WHEEL
+
+#include <cstdint>
+#include <vector>
+
+#include "entt.hpp"
+
+const int TIMER_WHEEL_BITS(6);
+const int TIMER_WHEEL_SLOTS(1 << TIMER_WHEEL_BITS);  // Slots per level
+const uint32_t TIMER_WHEEL_MASK(TIMER_WHEEL_SLOTS - 1);
+const int TIMER_WHEEL_LEVELS(3);  // 64^3 ticks, about 72 minutes at 60 ticks/s
+const int32_t TIMER_WHEEL_NONE(-1);  // End of a slot's list
+
+// Hierarchical timer wheel keyed by simulation tick.
+// Level 0 holds timers due within the next 64 ticks, one slot per tick. Each
+// higher level covers 64 times the span of the one below and is cascaded
+// down whenever the lower level wraps around, so every tick only touches the
+// timers that are actually expiring.
+// Every slot is a list threaded through one shared pool of entries, in the
+// order the timers were added. Moving a timer between slots only relinks
+// it, and an expired timer's entry is reused by the next one scheduled, so
+// the pool only grows when more timers are pending than ever before.
+struct TimerWheel {
+  struct Entry {
+    entt::entity entity;
+    uint32_t dueTick;
+    int32_t next;  // Next entry in the same list, or the free list
+  };
+
+  struct List {
+    int32_t first = TIMER_WHEEL_NONE;
+    int32_t last = TIMER_WHEEL_NONE;
+  };
+
+  std::vector<Entry> entries;
+  int32_t freeEntries = TIMER_WHEEL_NONE;
+  List slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+  List overflow;  // Timers further away than the top level
+  uint32_t currentTick = 0;
+
+  // Register an entity to fire on dueTick (at the earliest on the next tick)
+  void schedule(const entt::entity e, uint32_t dueTick) {
+    if (dueTick <= currentTick) dueTick = currentTick + 1;
+    int32_t index = freeEntries;
+    if (index == TIMER_WHEEL_NONE) {
+      index = int32_t(entries.size());
+      entries.push_back({});
+    } else {
+      freeEntries = entries[index].next;
+    }
+    entries[index].entity = e;
+    entries[index].dueTick = dueTick;
+    insert(index);
+  }
+
+  // Step one tick and collect the entities whose timers expire on it.
+  // Entries are not removed when an entity dies, so callers should check that
+  // the entity is still valid and still due on this tick.
+  template <typename EntityList>
+  void advance(EntityList& expired) {
+    currentTick++;
+    if ((currentTick & TIMER_WHEEL_MASK) == 0) {
+      cascade(1);
+    }
+
+    int32_t index = take(slots[0][currentTick & TIMER_WHEEL_MASK]);
+    while (index != TIMER_WHEEL_NONE) {
+      int32_t next = entries[index].next;
+      if (entries[index].dueTick == currentTick) {
+        expired.push_back(entries[index].entity);
+        entries[index].next = freeEntries;
+        freeEntries = index;
+      } else {
+        insert(index);
+      }
+      index = next;
+    }
+  }
+
+  // Room for this many pending timers without growing the pool
+  void reserve(const size_t timers) { entries.reserve(timers); }
+
+  void clear() {
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+      for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+        slots[level][slot] = List();
+      }
+    }
+    overflow = List();
+    entries.clear();
+    freeEntries = TIMER_WHEEL_NONE;
+  }
+
+  // Append an entry to the list of the slot its due tick falls in
+  void insert(const int32_t index) {
+    Entry& entry = entries[index];
+    entry.next = TIMER_WHEEL_NONE;
+    List* list = &overflow;
+    uint32_t delta = entry.dueTick - currentTick;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+      int shift = TIMER_WHEEL_BITS * level;
+      if (delta < (uint32_t(1) << (shift + TIMER_WHEEL_BITS))) {
+        list = &slots[level][(entry.dueTick >> shift) & TIMER_WHEEL_MASK];
+        break;
+      }
+    }
+
+    if (list->last == TIMER_WHEEL_NONE) {
+      list->first = index;
+    } else {
+      entries[list->last].next = index;
+    }
+    list->last = index;
+  }
+
+  // Empty a list and return its first entry, the rest still chained on
+  int32_t take(List& list) {
+    int32_t first = list.first;
+    list = List();
+    return first;
+  }
+
+  // Move the current slot of a level down into the lower levels
+  void cascade(const int level) {
+    List* moving = &overflow;
+    if (level < TIMER_WHEEL_LEVELS) {
+      uint32_t index =
+        (currentTick >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+      if (index == 0) cascade(level + 1);
+      moving = &slots[level][index];
+    }
+    int32_t entry = take(*moving);
+    while (entry != TIMER_WHEEL_NONE) {
+      int32_t next = entries[entry].next;
+      insert(entry);
+      entry = next;
+    }
+  }
+};
+
+#endif
@@ -637,6 +637,8 @@ struct GameOverScreen : Menu {
 struct HPAndScoreGUI : Menu {
   Label healthLabel, scoreLabel, scoreOutput;
   Bar hpBar;
+  int shownHealth = -1, shownScore = -1;
+  bool dirty = true;  // HP or score changed since the HUD was last drawn
   
   void createUI(float windowWidth, float windowHeight) override {
     uiLibrary.rootContainer.bounds = {0, 0, windowWidth, 100};
@@ -680,8 +682,13 @@ struct HPAndScoreGUI : Menu {
   void Update() override { 
     uiLibrary.Update(); 
 
-    hpBar.UpdateBar(health);
-    scoreOutput.text = std::to_string(newScore);
+    if (health != shownHealth || newScore != shownScore) {
+      shownHealth = health;
+      shownScore = newScore;
+      hpBar.UpdateBar(health);
+      scoreOutput.text = std::to_string(newScore);
+      dirty = true;
+    }
   }
 };
 
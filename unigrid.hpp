@@ -4,19 +4,32 @@
 #include <raylib.h>
 #include <raymath.h>
 
+#include <cstdint>
 #include <cstdio>
 #include <cmath>
 #include <vector>
 
+#include "arena.hpp"
 #include "entt.hpp"
 #include "components.hpp"
 
 static Vector2 convertToUnigridPosition(const Vector2 position, const float gridCellSize);
 
+const int32_t UNIGRID_NONE(-1);  // End of a cell's list
+
+// One entity in one cell, chained to the next entity in the same cell
+struct GridEntry {
+  entt::entity entity;
+  int32_t next;
+};
+
 struct Cell {
   Vector2 topLeft;
   int size;
-  std::vector<entt::entity> objects;
+  // List of the cell's entities in the grid's entry pool, in insert order
+  int32_t first = UNIGRID_NONE;
+  int32_t last = UNIGRID_NONE;
+  int count = 0;
 
   Cell() {}
 
@@ -33,7 +46,7 @@ struct Cell {
       sprintf(buffer, "%d,%d", x, y);
       DrawText(buffer, topLeft.x, topLeft.y, 12, BLACK);
 
-      sprintf(buffer, "%d", objects.size());
+      sprintf(buffer, "%d", count);
       DrawText(
         buffer, topLeft.x + (size / 2), topLeft.y + (size / 2), 15, GREEN
       );
@@ -41,13 +54,26 @@ struct Cell {
   }
 };
 
+// The cells share one pool of entries rather than each owning a vector, so
+// the memory a grid needs follows the number of entities it holds, not
+// entities times cells. The grid is refilled every tick, so the pool lives
+// in the frame arena and is handed a new buffer whenever the cells clear.
 struct UniformGrid {
   std::vector<std::vector<Cell>> cells;  // [row][column], [y][x]
+  ArenaVector<GridEntry> entries;
+  // Entities overlapping the ring of cells just outside the window. Not used
+  // for collisions, only so drawing can find sprites that hang over the edge.
+  ArenaVector<entt::entity> edgeObjects;
   int gridCellSize;
+  size_t reservedEntries = 0;
+  size_t reservedEdgeObjects = 0;
 
   UniformGrid(
-    const int _windowHeight, const int _windowWidth, const float _gridCellSize
-  ) {
+    const int _windowHeight, const int _windowWidth, const float _gridCellSize,
+    FrameArena& arena
+  )
+      : entries(ArenaAllocator<GridEntry>(&arena)),
+        edgeObjects(ArenaAllocator<entt::entity>(&arena)) {
     gridCellSize = _gridCellSize;
 
     for (size_t i = 0; i < _windowHeight; i += gridCellSize) {
@@ -60,19 +86,42 @@ struct UniformGrid {
     }
   }
 
-  void refreshPosition(entt::registry& r, entt::entity e) {
-		CharacterComponent* cc = r.try_get<CharacterComponent>(e);
-		if (!cc) return;
-
-    for (size_t j = 0; j < cc->unigridPositions.size(); j++) {
-      int gridX = cc->unigridPositions[j].x;
-      int gridY = cc->unigridPositions[j].y;
-      // Only add if object is inside cells within screen borders
-      bool isInsideValidCell = gridY < cells.size() && gridX < cells[0].size();
-      if (isInsideValidCell) {
-        cells[gridY][gridX].objects.push_back(e);
+  // Add an entity to every cell overlapped by its hitbox's bounding box
+  void insert(const entt::entity e, const CharacterComponent& cc) {
+    // Get the min(bottom-left) and max(top-right) extents of the Circle (just
+    // like an AABB)
+    Vector2 minGridPosition = convertToUnigridPosition(
+      {cc.position.x - cc.hitboxRadius, cc.position.y + cc.hitboxRadius},
+      gridCellSize
+    );
+    Vector2 maxGridPosition = convertToUnigridPosition(
+      {cc.position.x + cc.hitboxRadius, cc.position.y - cc.hitboxRadius},
+      gridCellSize
+    );
+
+    bool touchesEdge = false;
+    for (int gridX = minGridPosition.x; gridX <= maxGridPosition.x; gridX++) {
+      for (int gridY = minGridPosition.y; gridY >= maxGridPosition.y; gridY--) {
+        // Only add if object is inside cells within screen borders
+        bool isInsideValidCell = gridX >= 0 && gridY >= 0 &&
+                                 gridY < cells.size() && gridX < cells[0].size();
+        if (isInsideValidCell) {
+          append(cells[gridY][gridX], e);
+        } else if (gridX >= -1 && gridY >= -1 && gridY <= int(cells.size()) &&
+                   gridX <= int(cells[0].size())) {
+          touchesEdge = true;
+        }
       }
     }
+    if (touchesEdge) edgeObjects.push_back(e);
+  }
+
+  // Refill from scratch, for when the world changed without a tick
+  void rebuild(entt::registry& registry) {
+    clearCells();
+    for (auto [e, cc] : registry.storage<CharacterComponent>().each()) {
+      insert(e, cc);
+    }
   }
 
   void draw() {
@@ -83,43 +132,44 @@ struct UniformGrid {
     }
   }
 
+  void append(Cell& cell, const entt::entity e) {
+    int32_t index = int32_t(entries.size());
+    entries.push_back({e, UNIGRID_NONE});
+    if (cell.last == UNIGRID_NONE) {
+      cell.first = index;
+    } else {
+      entries[cell.last].next = index;
+    }
+    cell.last = index;
+    cell.count++;
+  }
+
+  // Room for this many entities with hitboxes up to maxHitboxRadius, each in
+  // every cell its bounding box can overlap, so inserts never reallocate.
+  // Taken from the arena again on every clear.
+  void reserveCells(const size_t entities, const float maxHitboxRadius) {
+    size_t span = size_t(std::ceil(2.0f * maxHitboxRadius / gridCellSize)) + 1;
+    reservedEntries = entities * span * span;
+    reservedEdgeObjects = entities;
+    entries.reserve(reservedEntries);
+    edgeObjects.reserve(reservedEdgeObjects);
+  }
+
+  // In a tick, call right after the arena's reset() so the new buffers
+  // come from this tick's memory
   void clearCells() {
     for (size_t i = 0; i < cells.size(); i++) {
       for (size_t j = 0; j < cells[i].size(); j++) {
-        cells[i][j].objects.clear();
+        cells[i][j].first = UNIGRID_NONE;
+        cells[i][j].last = UNIGRID_NONE;
+        cells[i][j].count = 0;
       }
     }
+    renewArenaVector(entries, reservedEntries);
+    renewArenaVector(edgeObjects, reservedEdgeObjects);
   }
 };
 
-static void refreshUnigridPositions(CharacterComponent* character, const float gridCellSize) {
-  // Get the min(bottom-left) and max(top-right) extents of the Circle (just
-  // like an AABB)
-  Vector2 min = {
-    character->position.x - character->hitboxRadius, character->position.y + character->hitboxRadius};
-  Vector2 max = {
-    character->position.x + character->hitboxRadius, character->position.y - character->hitboxRadius};
-
-  Vector2 minGridPosition = convertToUnigridPosition(min, gridCellSize);
-  Vector2 maxGridPosition = convertToUnigridPosition(max, gridCellSize);
-
-  character->unigridPositions.clear();
-
-  if (Vector2Equals(minGridPosition, maxGridPosition)) {
-    // If the circle is in only one cell:
-    character->unigridPositions.push_back(minGridPosition);
-  } else {
-    // Occupies spaces that are in between min and max
-    for (int i = minGridPosition.x; i <= maxGridPosition.x; i++) {
-      for (int j = minGridPosition.y; j >= maxGridPosition.y; j--) {
-        Vector2 newGridPosition = {
-          static_cast<float>(i), static_cast<float>(j)};
-        character->unigridPositions.push_back(newGridPosition);
-      }
-    }
-  }
-}
-
 static Vector2 convertToUnigridPosition(const Vector2 position, const float gridCellSize) {
   Vector2 gridPosition = {
     floor(position.x / gridCellSize), floor(position.y / gridCellSize)};